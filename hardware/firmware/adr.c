@@ -0,0 +1,82 @@
+// adr.c
+#include "adr.h"
+
+#include <string.h>
+
+#include "lora_RFM95.h"
+#include "trace.h"
+
+static struct {
+    uint8_t sf;
+    int8_t power_dbm;
+    int8_t pending_power_dbm; // Potência menor pedida, à espera de confirmação
+    uint8_t power_votes;
+    uint8_t timeouts;         // ACKs perdidos seguidos
+    uint8_t applied;          // FRAME_ADR() do último adr_apply(): o que o rádio usa
+} adr;
+
+void adr_init(void) {
+    memset(&adr, 0, sizeof(adr));
+    adr.sf = LORA_SF_MAX;
+    adr.power_dbm = LORA_POWER_MAX_DBM;
+    adr.applied = FRAME_ADR(adr.sf, adr.power_dbm); // O boot é em LORA_SF_MAX e potência máxima
+}
+
+void adr_on_ack(const frame_ack_t *ack) {
+    adr.timeouts = 0;
+    if (ack->adr == 0) return;
+
+    const uint8_t sf = FRAME_ADR_SF(ack->adr);
+    const int8_t power = FRAME_ADR_POWER_DBM(ack->adr);
+    if (sf < LORA_SF_MIN || sf > LORA_SF_MAX || power < LORA_POWER_MIN_DBM) return;
+
+    bool changed = false;
+    if (sf != adr.sf) {
+        adr.sf = sf;
+        changed = true;
+    }
+
+    if (power > adr.power_dbm) {
+        // Mais potência: enlace piorando, vale na hora
+        adr.power_dbm = power;
+        adr.power_votes = 0;
+        changed = true;
+    } else if (power < adr.power_dbm) {
+        if (power != adr.pending_power_dbm) {
+            adr.pending_power_dbm = power;
+            adr.power_votes = 0;
+        }
+        if (++adr.power_votes >= ADR_POWER_CONFIRM) {
+            adr.power_dbm = power;
+            adr.power_votes = 0;
+            changed = true;
+        }
+    } else {
+        adr.power_votes = 0;
+    }
+
+    if (changed) {
+        TRACE_INFO(ADR_CHANGE, adr.sf, adr.power_dbm);
+    }
+}
+
+void adr_on_ack_timeout(void) {
+    if (++adr.timeouts < ADR_FALLBACK_TIMEOUTS) return;
+    if (adr.sf == LORA_SF_MAX && adr.power_dbm == LORA_POWER_MAX_DBM) return;
+
+    // O gateway faz o mesmo ao deixar de ouvir o nó
+    adr.sf = LORA_SF_MAX;
+    adr.power_dbm = LORA_POWER_MAX_DBM;
+    adr.power_votes = 0;
+    TRACE_WARN(ADR_FALLBACK, adr.sf, adr.timeouts);
+}
+
+void adr_apply(void) {
+    lora_set_sf(adr.sf);
+    lora_set_power(adr.power_dbm);
+    adr.applied = FRAME_ADR(adr.sf, adr.power_dbm);
+}
+
+uint8_t adr_report(void) {
+    return adr.applied;
+}
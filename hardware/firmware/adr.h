@@ -0,0 +1,55 @@
+// adr.h
+#ifndef ADR_H_
+#define ADR_H_
+
+#include <stdint.h>
+
+#include "lora_frame.h"
+
+// ============================
+// === Configuração ===
+// ============================
+// O gateway mede a margem do enlace e comanda taxa e potência nos ACKs. O
+// SF segue o comando à risca (é o que o gateway vai ouvir no slot); a
+// potência só baixa depois de pedida em ADR_POWER_CONFIRM ACKs seguidos.
+
+// ACKs perdidos seguidos antes de voltar a LORA_SF_MAX e potência máxima,
+// onde nó e gateway sempre se reencontram
+#define ADR_FALLBACK_TIMEOUTS 3
+
+// ACKs seguidos pedindo menos potência antes de baixar
+#define ADR_POWER_CONFIRM 2
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Começa no enlace mais robusto: LORA_SF_MAX, potência máxima.
+ */
+void adr_init(void);
+
+/**
+ * @brief Aplica o comando de taxa e potência de um ACK.
+ */
+void adr_on_ack(const frame_ack_t *ack);
+
+/**
+ * @brief Conta um ACK perdido; após ADR_FALLBACK_TIMEOUTS volta ao enlace
+ * mais robusto.
+ */
+void adr_on_ack_timeout(void);
+
+/**
+ * @brief Configura o rádio com a taxa e a potência atuais. Chamar depois
+ * do beacon (que é sempre ouvido em LORA_SF_MAX) e antes do slot.
+ */
+void adr_apply(void);
+
+/**
+ * @brief Taxa e potência em uso no rádio (FRAME_ADR()), para o campo adr
+ * dos lotes: é por ele que o gateway sabe que um comando foi aplicado.
+ */
+uint8_t adr_report(void);
+
+#endif // ADR_H_
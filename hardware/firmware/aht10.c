@@ -3,19 +3,11 @@
 #include <generated/csr.h>
 #include <system.h>
 
-// Esta função é necessária pelo driver I2C e AHT10
-static void busy_wait_ms(unsigned int ms) {
-    for (unsigned int i = 0; i < ms; ++i) {
-#ifdef CSR_TIMER0_BASE
-        busy_wait_us(1000);
-#else
-        for(volatile int j = 0; j < 1000; j++);
-#endif
-    }
-}
+#include "timebase.h"
+#include "trace.h"
 
 static uint32_t i2c_w_reg = 0;
-static void i2c_delay(void) { busy_wait_us(5); }
+static void i2c_delay(void) { timebase_delay_us(5); }
 
 static void i2c_set_scl(int val) {
     if (val) i2c_w_reg |= (1 << CSR_I2C_W_SCL_OFFSET);
@@ -42,7 +34,7 @@ static int i2c_read_sda(void) {
 // --- Funções Públicas (do aht10.h) ---
 void i2c_init(void) {
     i2c_set_oe(1); i2c_set_scl(1); i2c_set_sda(1);
-    busy_wait_ms(1);
+    timebase_delay_ms(1);
 }
 
 // --- Funções Internas (static) ---
@@ -98,7 +90,7 @@ void i2c_scan(void) {
             printf("  Dispositivo encontrado em 0x%02X\n", addr);
         }
         i2c_stop();
-        busy_wait_us(100);
+        timebase_delay_us(100);
     }
     printf("Scan completo.\n");
 }
@@ -112,7 +104,7 @@ int aht10_init(void) {
     if (!i2c_write_byte(0x08)) { i2c_stop(); return -1; }
     if (!i2c_write_byte(0x00)) { i2c_stop(); return -1; }
     i2c_stop();
-    busy_wait_ms(100);
+    timebase_delay_ms(100);
     return 0;
 }
 
@@ -127,7 +119,7 @@ bool aht10_get_data(sensor_data_T *d) {
     if (!i2c_write_byte(0x00)) { i2c_stop(); return false; }
     i2c_stop();
 
-    busy_wait_ms(80);
+    timebase_delay_ms(80);
 
     i2c_start();
     if (!i2c_write_byte(AHT10_I2C_ADDR << 1 | 1)) { i2c_stop(); return false; } // Leitura
@@ -140,7 +132,7 @@ bool aht10_get_data(sensor_data_T *d) {
     i2c_stop();
 
     if (data[0] & 0x80) {
-        printf("Erro: AHT10 ainda ocupado.\n");
+        TRACE_WARN(SENSOR_BUSY, 0, 0);
         return false;
     }
 
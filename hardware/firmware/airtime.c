@@ -0,0 +1,60 @@
+// airtime.c
+#include "airtime.h"
+
+#include <string.h>
+
+#include "prng.h"
+#include "timebase.h"
+
+#define AIRTIME_BUCKET_US ((uint64_t)AIRTIME_BUCKET_MS * 1000)
+
+static struct {
+    uint64_t balance_us;  // Saldo, até AIRTIME_BUCKET_US
+    uint64_t last_refill; // Em ciclos
+    uint64_t boot;
+    airtime_stats_t stats;
+} airtime;
+
+// Credita o tempo decorrido desde a última vez, na proporção do duty cycle
+static void airtime_refill(void) {
+    const uint64_t now = timebase_ticks64();
+    const uint64_t elapsed_us = (now - airtime.last_refill) / TIMEBASE_TICKS_PER_US;
+
+    airtime.balance_us += elapsed_us * AIRTIME_DUTY_PERMILLE / 1000;
+    if (airtime.balance_us > AIRTIME_BUCKET_US) airtime.balance_us = AIRTIME_BUCKET_US;
+    // Avança só o que foi creditado: o resto da divisão não se perde
+    airtime.last_refill += elapsed_us * TIMEBASE_TICKS_PER_US;
+}
+
+void airtime_init(void) {
+    memset(&airtime, 0, sizeof(airtime));
+    airtime.balance_us = AIRTIME_BUCKET_US;
+    airtime.boot = airtime.last_refill = timebase_ticks64();
+}
+
+bool airtime_request(uint32_t airtime_us) {
+    airtime_refill();
+    if (airtime.balance_us >= airtime_us) return true;
+    airtime.stats.deferred++;
+    return false;
+}
+
+void airtime_charge(uint32_t airtime_us) {
+    airtime_refill();
+    airtime.balance_us = airtime.balance_us > airtime_us ? airtime.balance_us - airtime_us : 0;
+    airtime.stats.frames++;
+    airtime.stats.airtime_us += airtime_us;
+}
+
+uint32_t airtime_jitter_ms(uint32_t max_ms) {
+    return prng_next() % (max_ms + 1);
+}
+
+airtime_stats_t airtime_get_stats(void) {
+    airtime_refill();
+
+    const uint64_t uptime_us = (timebase_ticks64() - airtime.boot) / TIMEBASE_TICKS_PER_US;
+    airtime.stats.balance_us = (uint32_t)airtime.balance_us;
+    airtime.stats.used_permille = uptime_us ? (uint32_t)(airtime.stats.airtime_us * 1000 / uptime_us) : 0;
+    return airtime.stats;
+}
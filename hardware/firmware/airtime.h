@@ -0,0 +1,63 @@
+// airtime.h
+#ifndef AIRTIME_H_
+#define AIRTIME_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================
+// === Configuração ===
+// ============================
+// Fração do tempo que o nó pode ocupar o canal, em milésimos (make DUTY=n).
+// O balde recebe esse tanto de tempo no ar por tempo decorrido.
+#ifndef AIRTIME_DUTY_PERMILLE
+#define AIRTIME_DUTY_PERMILLE 100 // 10%
+#endif
+
+// Capacidade do balde: rajada máxima depois de um tempo ocioso
+#ifndef AIRTIME_BUCKET_MS
+#define AIRTIME_BUCKET_MS 10000
+#endif
+
+/**
+ * @brief Contadores do orçamento de tempo no ar desde o boot.
+ */
+typedef struct {
+    uint32_t frames;        // Quadros cobrados
+    uint64_t airtime_us;    // Tempo no ar cobrado
+    uint32_t deferred;      // Envios adiados por falta de saldo
+    uint32_t balance_us;    // Saldo atual do balde
+    uint32_t used_permille; // Tempo no ar / tempo decorrido desde o boot
+} airtime_stats_t;
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Enche o balde.
+ */
+void airtime_init(void);
+
+/**
+ * @brief Verifica se o saldo cobre um quadro. Não cobra: chame
+ * airtime_charge() depois do envio.
+ * @param airtime_us Tempo no ar do quadro (lora_time_on_air_us()).
+ * @return true se pode transmitir; false conta um envio adiado.
+ */
+bool airtime_request(uint32_t airtime_us);
+
+/**
+ * @brief Desconta um quadro transmitido do saldo.
+ */
+void airtime_charge(uint32_t airtime_us);
+
+/**
+ * @brief Atraso aleatório para o início de um envio (prng.h).
+ * @return Valor uniforme em 0 .. max_ms.
+ */
+uint32_t airtime_jitter_ms(uint32_t max_ms);
+
+airtime_stats_t airtime_get_stats(void);
+
+#endif // AIRTIME_H_
@@ -0,0 +1,120 @@
+// arq.c
+#include "arq.h"
+
+#include <string.h>
+
+#include "lora_RFM95.h"
+#include "timebase.h"
+#include "trace.h"
+
+// Folga da janela do ACK além do atraso máximo e do tempo no ar
+#define ARQ_WINDOW_MARGIN_MS 50
+
+typedef struct {
+    frame_sample_t sample;
+    uint8_t tx_count; // Envios sem confirmação
+} arq_entry_t;
+
+static struct {
+    arq_entry_t queue[ARQ_QUEUE_SIZE]; // Mais antiga primeiro
+    uint8_t count;
+    uint8_t inflight;                  // Amostras no último quadro montado
+    uint16_t next_seq;
+    arq_stats_t stats;
+} arq;
+
+static void arq_remove(uint8_t index) {
+    memmove(&arq.queue[index], &arq.queue[index + 1], (arq.count - index - 1) * sizeof(arq.queue[0]));
+    arq.count--;
+}
+
+void arq_init(void) {
+    memset(&arq, 0, sizeof(arq));
+}
+
+uint16_t arq_push(int16_t temperatura, int16_t umidade) {
+    if (arq.count == ARQ_QUEUE_SIZE) {
+        arq.stats.dropped_overflow++;
+        TRACE_WARN(ARQ_DROPPED, 0, arq.queue[0].sample.seq);
+        arq_remove(0);
+    }
+
+    arq_entry_t *e = &arq.queue[arq.count++];
+    e->sample.seq = arq.next_seq++;
+    e->sample.temperatura = temperatura;
+    e->sample.umidade = umidade;
+    e->tx_count = 0;
+    return e->sample.seq;
+}
+
+uint8_t arq_pending(void) {
+    return arq.count;
+}
+
+size_t arq_frame_len(void) {
+    return FRAME_BATCH_LEN(arq.count < FRAME_BATCH_MAX ? arq.count : FRAME_BATCH_MAX);
+}
+
+size_t arq_build(frame_batch_t *frame) {
+    arq.inflight = arq.count < FRAME_BATCH_MAX ? arq.count : FRAME_BATCH_MAX;
+    for (uint8_t i = 0; i < arq.inflight; i++) {
+        frame->samples[i] = arq.queue[i].sample;
+        if (arq.queue[i].tx_count > 0) arq.stats.retransmitted++;
+    }
+    return FRAME_BATCH_LEN(arq.inflight);
+}
+
+uint32_t arq_ack_window_ms(void) {
+    return FRAME_ACK_DELAY_MAX_MS + lora_time_on_air_us(sizeof(frame_ack_t)) / 1000 + ARQ_WINDOW_MARGIN_MS;
+}
+
+bool arq_wait_ack(uint8_t node_id, uint16_t frame_seq, frame_ack_t *ack) {
+    uint8_t buf[sizeof(frame_ack_t)];
+    const uint64_t deadline = timebase_ticks64() + (uint64_t)arq_ack_window_ms() * TIMEBASE_TICKS_PER_MS;
+
+    // Class A: só escuta logo depois do próprio envio
+    lora_start_rx_continuous();
+    while (timebase_ticks64() < deadline) {
+        if (lora_receive_bytes(buf, sizeof(buf)) != sizeof(frame_ack_t)) continue;
+
+        memcpy(ack, buf, sizeof(*ack));
+        if (FRAME_TYPE(&ack->header) != FRAME_TYPE_ACK) continue;
+        if (ack->header.node_id != node_id || ack->header.seq != frame_seq) continue;
+
+        lora_set_mode(0x01); // Standby
+        return true;
+    }
+    lora_set_mode(0x01); // Standby
+
+    arq.stats.ack_timeouts++;
+    TRACE_WARN(ARQ_ACK_TIMEOUT, 0, frame_seq);
+    return false;
+}
+
+void arq_complete(const frame_ack_t *ack) {
+    for (uint8_t i = 0; i < arq.inflight && i < arq.count; i++) {
+        arq.queue[i].tx_count++;
+    }
+    arq.inflight = 0;
+
+    uint8_t i = 0;
+    while (i < arq.count) {
+        const arq_entry_t *e = &arq.queue[i];
+        const uint16_t back = (uint16_t)(ack ? ack->base_seq - e->sample.seq : 0xFFFF);
+
+        if (ack && back < 16 && (ack->bitmap & (1u << back))) {
+            arq.stats.acked++;
+            arq_remove(i);
+        } else if (e->tx_count >= ARQ_MAX_TX) {
+            arq.stats.dropped_retries++;
+            TRACE_WARN(ARQ_DROPPED, (int16_t)e->tx_count, e->sample.seq);
+            arq_remove(i);
+        } else {
+            i++;
+        }
+    }
+}
+
+arq_stats_t arq_get_stats(void) {
+    return arq.stats;
+}
@@ -0,0 +1,90 @@
+// arq.h
+#ifndef ARQ_H_
+#define ARQ_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "lora_frame.h"
+
+// ============================
+// === Configuração ===
+// ============================
+// Amostras guardadas à espera de confirmação; com a fila cheia a mais
+// antiga é descartada
+#define ARQ_QUEUE_SIZE 8
+
+// Transmissões de uma amostra sem ACK antes de desistir dela
+#define ARQ_MAX_TX 4
+
+/**
+ * @brief Contadores do ARQ desde o boot.
+ */
+typedef struct {
+    uint32_t acked;            // Amostras confirmadas
+    uint32_t retransmitted;    // Amostras reenviadas
+    uint32_t dropped_retries;  // Descartadas após ARQ_MAX_TX envios
+    uint32_t dropped_overflow; // Descartadas com a fila cheia
+    uint32_t ack_timeouts;     // Janelas de recepção sem ACK
+} arq_stats_t;
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Esvazia a fila; as amostras recomeçam do seq 0.
+ */
+void arq_init(void);
+
+/**
+ * @brief Acrescenta uma leitura nova à fila.
+ * @return seq da amostra.
+ */
+uint16_t arq_push(int16_t temperatura, int16_t umidade);
+
+/**
+ * @brief Amostras na fila (ainda sem confirmação).
+ */
+uint8_t arq_pending(void);
+
+/**
+ * @brief Tamanho do próximo quadro em lote, para reservar o slot.
+ */
+size_t arq_frame_len(void);
+
+/**
+ * @brief Copia para o quadro as amostras mais antigas da fila (até
+ * FRAME_BATCH_MAX). O cabeçalho fica a cargo de quem envia.
+ * @return Tamanho do quadro em bytes.
+ */
+size_t arq_build(frame_batch_t *frame);
+
+/**
+ * @brief Abre a janela de recepção após o TxDone e espera o ACK do gateway.
+ * @param node_id Este nó (destino do ACK).
+ * @param frame_seq seq do quadro enviado, repetido no ACK.
+ * @param ack Recebe o ACK.
+ * @return true se o ACK chegou dentro da janela.
+ */
+bool arq_wait_ack(uint8_t node_id, uint16_t frame_seq, frame_ack_t *ack);
+
+/**
+ * @brief Fecha a troca do último arq_build(): retira da fila as amostras
+ * confirmadas no bitmap e descarta as que esgotaram ARQ_MAX_TX envios.
+ * @param ack ACK recebido, ou NULL se ele não veio (ou o envio falhou).
+ */
+void arq_complete(const frame_ack_t *ack);
+
+/**
+ * @brief Tempo, em ms, que a janela do ACK ocupa depois do TxDone.
+ */
+uint32_t arq_ack_window_ms(void);
+
+/**
+ * @brief Contadores do ARQ.
+ */
+arq_stats_t arq_get_stats(void);
+
+#endif // ARQ_H_
@@ -0,0 +1,161 @@
+// bulk.c
+#include "bulk.h"
+
+#include <string.h>
+
+#include "lora_RFM95.h"
+#include "timebase.h"
+#include "trace.h"
+
+// Tempo de um fragmento além do ar: FIFO pelo SPI e troca de modo
+#define BULK_FRAGMENT_OVERHEAD_US 1000
+
+static struct {
+    frame_sample_t log[BULK_LOG_SAMPLES]; // Anel, a partir de tail
+    uint16_t tail;                        // Leitura mais antiga não confirmada
+    uint16_t count;
+    uint16_t next_fragment;               // seq do próximo fragmento
+    bulk_stats_t stats;
+} bulk;
+
+void bulk_init(void) {
+    memset(&bulk, 0, sizeof(bulk));
+}
+
+void bulk_log(uint16_t seq, int16_t temperatura, int16_t umidade) {
+    if (bulk.count == BULK_LOG_SAMPLES) {
+        bulk.tail = (uint16_t)((bulk.tail + 1) % BULK_LOG_SAMPLES);
+        bulk.count--;
+        bulk.stats.overwritten++;
+    }
+
+    frame_sample_t *s = &bulk.log[(bulk.tail + bulk.count) % BULK_LOG_SAMPLES];
+    s->seq = seq;
+    s->temperatura = temperatura;
+    s->umidade = umidade;
+    bulk.count++;
+    bulk.stats.logged++;
+}
+
+uint16_t bulk_pending(void) {
+    return bulk.count;
+}
+
+bool bulk_wanted(void) {
+    return bulk.count >= BULK_LOG_THRESHOLD;
+}
+
+bulk_stats_t bulk_get_stats(void) {
+    return bulk.stats;
+}
+
+// Fragmento index da janela: as leituras seguem a ordem do log a partir
+// da mais antiga ainda não confirmada
+static size_t bulk_build(frame_bulk_t *frame, uint8_t node_id, uint16_t window, uint8_t index, bool last) {
+    const uint16_t first = (uint16_t)index * FRAME_BULK_SAMPLES;
+    const uint16_t left = (uint16_t)(bulk.count - first);
+    const uint8_t n = left < FRAME_BULK_SAMPLES ? (uint8_t)left : FRAME_BULK_SAMPLES;
+
+    frame->header.node_id = node_id;
+    frame->header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_BULK, last ? FRAME_FLAG_ACK_REQ : 0);
+    frame->header.seq = (uint16_t)(window + index);
+    frame->window = window;
+    for (uint8_t i = 0; i < n; i++) {
+        frame->samples[i] = bulk.log[(bulk.tail + first + i) % BULK_LOG_SAMPLES];
+    }
+    return FRAME_BULK_LEN(n);
+}
+
+static bool bulk_wait_ack(uint8_t node_id, uint16_t window, uint16_t *bitmap) {
+    uint8_t buf[sizeof(frame_bulk_ack_t)];
+    frame_bulk_ack_t ack;
+    const uint64_t deadline = timebase_ticks64() + (uint64_t)BULK_ACK_TIMEOUT_MS * TIMEBASE_TICKS_PER_MS;
+
+    lora_fsk_start_rx();
+    while (timebase_ticks64() < deadline) {
+        if (lora_fsk_receive(buf, sizeof(buf)) != sizeof(ack)) continue;
+
+        memcpy(&ack, buf, sizeof(ack));
+        if (FRAME_TYPE(&ack.header) != FRAME_TYPE_BULK_ACK) continue;
+        if (ack.header.node_id != node_id || ack.header.seq != window) continue;
+
+        lora_set_mode(0x01); // Standby
+        *bitmap = ack.bitmap;
+        return true;
+    }
+    lora_set_mode(0x01); // Standby
+    return false;
+}
+
+// Tira do log as leituras dos fragmentos confirmados em sequência desde o
+// primeiro da janela; o resto volta numa janela nova
+static uint16_t bulk_release(uint16_t acked, uint8_t fragments) {
+    uint8_t done = 0;
+    while (done < fragments && (acked & (1u << done))) done++;
+
+    uint16_t n = (uint16_t)done * FRAME_BULK_SAMPLES;
+    if (n > bulk.count) n = bulk.count;
+    bulk.tail = (uint16_t)((bulk.tail + n) % BULK_LOG_SAMPLES);
+    bulk.count = (uint16_t)(bulk.count - n);
+    bulk.next_fragment = (uint16_t)(bulk.next_fragment + done);
+    bulk.stats.dumped += n;
+    return n;
+}
+
+uint16_t bulk_transfer(uint8_t node_id, uint64_t slot_end) {
+    const uint64_t deadline = slot_end - (uint64_t)BULK_SLOT_MARGIN_MS * TIMEBASE_TICKS_PER_MS;
+    const uint64_t fragment_ticks =
+        (uint64_t)(lora_fsk_time_on_air_us(sizeof(frame_bulk_t)) + BULK_FRAGMENT_OVERHEAD_US) * TIMEBASE_TICKS_PER_US;
+    const uint64_t ack_ticks = (uint64_t)BULK_ACK_TIMEOUT_MS * TIMEBASE_TICKS_PER_MS;
+    uint16_t confirmed = 0;
+    frame_bulk_t frame;
+
+    bulk.stats.sessions++;
+    lora_fsk_begin();
+    timebase_delay_ms(BULK_TURNAROUND_MS);
+
+    while (bulk.count > 0) {
+        const uint16_t window = bulk.next_fragment;
+        const uint16_t needed = (uint16_t)((bulk.count + FRAME_BULK_SAMPLES - 1) / FRAME_BULK_SAMPLES);
+        const uint8_t fragments = needed < FRAME_BULK_WINDOW ? (uint8_t)needed : FRAME_BULK_WINDOW;
+        const uint16_t all = (uint16_t)((1u << fragments) - 1);
+        uint16_t acked = 0, sent = 0;
+        uint8_t rounds = 0;
+
+        while (acked != all && rounds < BULK_MAX_ROUNDS) {
+            // Só começa a rodada se ela e o ACK cabem no que resta do slot
+            uint8_t missing = 0, last = 0;
+            for (uint8_t i = 0; i < fragments; i++) {
+                if (acked & (1u << i)) continue;
+                missing++;
+                last = i;
+            }
+            if (timebase_ticks64() + missing * fragment_ticks + ack_ticks > deadline) break;
+
+            for (uint8_t i = 0; i < fragments; i++) {
+                if (acked & (1u << i)) continue;
+                const size_t len = bulk_build(&frame, node_id, window, i, i == last);
+                if (sent & (1u << i)) bulk.stats.retransmitted++;
+                sent |= (uint16_t)(1u << i);
+                bulk.stats.fragments++;
+                lora_fsk_send((const uint8_t *)&frame, len);
+            }
+
+            uint16_t bitmap;
+            if (bulk_wait_ack(node_id, window, &bitmap) && (bitmap & all & ~acked)) {
+                acked |= bitmap & all;
+                rounds = 0;
+            } else {
+                rounds++;
+                TRACE_WARN(BULK_NO_PROGRESS, rounds, window);
+            }
+        }
+
+        confirmed += bulk_release(acked, fragments);
+        if (acked != all) break;
+    }
+
+    lora_fsk_end();
+    TRACE_INFO(BULK_DONE, (int16_t)bulk.count, confirmed);
+    return confirmed;
+}
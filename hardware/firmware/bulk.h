@@ -0,0 +1,82 @@
+// bulk.h
+#ifndef BULK_H_
+#define BULK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "lora_frame.h"
+
+// ============================
+// === Configuração ===
+// ============================
+// Leituras guardadas no log; cheio, a mais antiga é sobrescrita
+#define BULK_LOG_SAMPLES 1024
+
+// Leituras ainda não despejadas para o nó pedir um despejo
+#define BULK_LOG_THRESHOLD 64
+
+// Rodadas seguidas sem progresso numa janela antes de desistir do despejo
+#define BULK_MAX_ROUNDS 4
+
+// Espera pelo frame_bulk_ack_t depois do último fragmento da rodada
+#define BULK_ACK_TIMEOUT_MS 30
+
+// Espera após o ACK LoRa, enquanto o gateway troca para FSK
+#define BULK_TURNAROUND_MS 20
+
+// Folga antes do fim do slot: o rádio volta ao LoRa antes do próximo nó
+#define BULK_SLOT_MARGIN_MS 50
+
+/**
+ * @brief Contadores do log e dos despejos desde o boot.
+ */
+typedef struct {
+    uint32_t logged;        // Leituras guardadas
+    uint32_t overwritten;   // Sobrescritas antes de despejadas
+    uint32_t dumped;        // Confirmadas pelo gateway
+    uint32_t sessions;      // Despejos concedidos
+    uint32_t fragments;     // Fragmentos enviados
+    uint32_t retransmitted; // Fragmentos reenviados
+} bulk_stats_t;
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Esvazia o log.
+ */
+void bulk_init(void);
+
+/**
+ * @brief Guarda uma leitura no log, com o seq de amostra do ARQ.
+ */
+void bulk_log(uint16_t seq, int16_t temperatura, int16_t umidade);
+
+/**
+ * @brief Leituras do log ainda não confirmadas pelo gateway.
+ */
+uint16_t bulk_pending(void);
+
+/**
+ * @brief Indica se vale pedir um despejo (FRAME_FLAG_BULK no lote).
+ */
+bool bulk_wanted(void);
+
+/**
+ * @brief Despeja o log em FSK até o fim do slot: troca o modem, manda as
+ * janelas de fragmentos com reenvio seletivo e volta ao LoRa. Chamar logo
+ * após um ACK com FRAME_FLAG_BULK.
+ * @param node_id Este nó.
+ * @param slot_end Fim do slot do nó, em ciclos (tdma_slot_end()).
+ * @return Leituras confirmadas, que saem do log.
+ */
+uint16_t bulk_transfer(uint8_t node_id, uint64_t slot_end);
+
+/**
+ * @brief Contadores do log.
+ */
+bulk_stats_t bulk_get_stats(void);
+
+#endif // BULK_H_
@@ -0,0 +1,58 @@
+// fec.h
+//
+// Código de apagamento Reed-Solomon sistemático sobre GF(256), para
+// recuperar quadros inteiros perdidos. Há uma cópia em cada lado
+// (hardware/firmware e software/software/inc): as duas devem ser mantidas
+// iguais.
+//
+// Um grupo tem k símbolos de dados e m de paridade. A linha de paridade r
+// é a soma de coef(r, i) * dado i, com coef(r, i) = a^(r * i): a linha 0 é
+// o XOR simples dos dados. Quaisquer e <= m linhas recebidas recuperam e
+// dados perdidos (a matriz é de Vandermonde nos pontos a^i, distintos).
+#ifndef FEC_H_
+#define FEC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FEC_MAX_K 8 // Símbolos de dados por grupo
+#define FEC_MAX_M 4 // Símbolos de paridade por grupo
+
+/**
+ * @brief Monta as tabelas de log/exp de GF(256). Chamar uma vez no boot.
+ */
+void fec_init(void);
+
+/**
+ * @brief Coeficiente do dado `index` na linha de paridade `row`.
+ */
+uint8_t fec_coef(uint8_t row, uint8_t index);
+
+/**
+ * @brief Soma um símbolo de dados à linha de paridade (parity ^= coef * symbol).
+ * A paridade pode ser acumulada quadro a quadro, sem guardar o grupo.
+ * @param parity Linha de paridade, zerada antes do primeiro símbolo.
+ * @param row Linha (0 .. m-1).
+ * @param index Posição do símbolo no grupo (0 .. k-1).
+ * @param symbol Símbolo de dados; bytes além de len contam como zero.
+ * @param len Tamanho do símbolo.
+ */
+void fec_encode(uint8_t *parity, uint8_t row, uint8_t index, const uint8_t *symbol, size_t len);
+
+/**
+ * @brief Recupera os símbolos de dados ausentes de um grupo.
+ * @param k Símbolos de dados no grupo.
+ * @param data k buffers de len bytes; os ausentes recebem os dados recuperados.
+ * @param have_data Bit i: data[i] recebido.
+ * @param parity Linhas de paridade recebidas.
+ * @param rows Número de cada linha de parity[].
+ * @param parity_count Linhas recebidas.
+ * @param len Tamanho dos símbolos.
+ * @return Símbolos recuperados (0 se nada faltava), ou -1 com mais
+ * ausências do que linhas de paridade.
+ */
+int fec_decode(uint8_t k, uint8_t *const *data, uint32_t have_data,
+               const uint8_t *const *parity, const uint8_t *rows, uint8_t parity_count, size_t len);
+
+#endif // FEC_H_
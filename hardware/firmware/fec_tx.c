@@ -0,0 +1,69 @@
+// fec_tx.c
+#include "fec_tx.h"
+
+#include <string.h>
+
+#include "fec.h"
+
+static struct {
+    uint8_t k, m;
+    uint16_t base;      // seq do primeiro quadro do grupo
+    uint8_t count;      // Quadros de dados já somados
+    uint8_t next_row;   // Próxima linha de paridade a enviar
+    uint8_t symbol_len; // Maior símbolo do grupo
+    uint8_t parity[FRAME_FEC_MAX_M][FRAME_FEC_SYMBOL_MAX];
+} fec_tx;
+
+void fec_tx_init(uint8_t k, uint8_t m) {
+    memset(&fec_tx, 0, sizeof(fec_tx));
+    fec_tx.k = k;
+    fec_tx.m = m;
+    fec_init();
+}
+
+void fec_tx_add(const uint8_t *frame, size_t len) {
+    uint8_t symbol[FRAME_FEC_SYMBOL_MAX];
+    frame_header_t header;
+
+    if (len + 1 > FRAME_FEC_SYMBOL_MAX || fec_tx.count >= fec_tx.k) return;
+
+    memcpy(&header, frame, sizeof(header));
+    if (fec_tx.count == 0) {
+        fec_tx.base = header.seq;
+        fec_tx.symbol_len = 0;
+        memset(fec_tx.parity, 0, sizeof(fec_tx.parity));
+    }
+
+    // Símbolo [tamanho][quadro]: o receptor recupera também o tamanho
+    symbol[0] = (uint8_t)len;
+    memcpy(&symbol[1], frame, len);
+    if (len + 1 > fec_tx.symbol_len) fec_tx.symbol_len = (uint8_t)(len + 1);
+
+    for (uint8_t r = 0; r < fec_tx.m; r++) {
+        fec_encode(fec_tx.parity[r], r, fec_tx.count, symbol, len + 1);
+    }
+    fec_tx.count++;
+}
+
+bool fec_tx_parity_pending(void) {
+    return fec_tx.k > 0 && fec_tx.count == fec_tx.k;
+}
+
+size_t fec_tx_next_parity(frame_parity_t *frame, uint8_t node_id) {
+    const uint8_t row = fec_tx.next_row;
+
+    frame->header.node_id = node_id;
+    frame->header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_PARITY, 0);
+    frame->header.seq = fec_tx.base;
+    frame->k = fec_tx.k;
+    frame->m = fec_tx.m;
+    frame->row = row;
+    frame->symbol_len = fec_tx.symbol_len;
+    memcpy(frame->parity, fec_tx.parity[row], fec_tx.symbol_len);
+
+    if (++fec_tx.next_row == fec_tx.m) {
+        fec_tx.next_row = 0;
+        fec_tx.count = 0;
+    }
+    return FRAME_PARITY_LEN(fec_tx.symbol_len);
+}
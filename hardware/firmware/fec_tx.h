@@ -0,0 +1,41 @@
+// fec_tx.h
+#ifndef FEC_TX_H_
+#define FEC_TX_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "lora_frame.h"
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Configura os grupos: k quadros de dados seguidos de m de paridade.
+ * @param k Quadros de dados por grupo (1 .. FRAME_FEC_MAX_K).
+ * @param m Quadros de paridade por grupo (1 .. FRAME_FEC_MAX_M).
+ */
+void fec_tx_init(uint8_t k, uint8_t m);
+
+/**
+ * @brief Soma um quadro de dados (já com cabeçalho) às paridades do grupo.
+ * Chamar antes do envio: mesmo um quadro que não chegar ao ar pode ser
+ * recuperado pelo receptor.
+ */
+void fec_tx_add(const uint8_t *frame, size_t len);
+
+/**
+ * @brief Indica se o grupo fechou e há paridade a enviar.
+ */
+bool fec_tx_parity_pending(void);
+
+/**
+ * @brief Monta o próximo quadro de paridade do grupo fechado.
+ * Após a última linha um novo grupo começa.
+ * @return Tamanho do quadro em bytes.
+ */
+size_t fec_tx_next_parity(frame_parity_t *frame, uint8_t node_id);
+
+#endif // FEC_TX_H_
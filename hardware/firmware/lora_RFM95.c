@@ -6,7 +6,13 @@
 #include <generated/csr.h>
 #include <system.h> 
 
+#include "lora_channels.h"
+#include "prng.h"
+#include "timebase.h"
+#include "trace.h"
+
 #define TX_TIMEOUT_MS 5000
+#define CAD_SYMBOLS 2 // Um CAD leva pouco mais de 1 símbolo; 2 cobre o processamento
 
 #define SPI_MODE_MANUAL (1 << 16)
 #define SPI_CS_MASK     0x0001
@@ -21,8 +27,10 @@
 #define REG_FIFO_ADDR_PTR        0x0D
 #define REG_FIFO_TX_BASE_ADDR    0x0E
 #define REG_FIFO_RX_BASE_ADDR    0x0F
+#define REG_FIFO_RX_CURRENT_ADDR 0x10
 #define REG_IRQ_FLAGS_MASK       0x11
 #define REG_IRQ_FLAGS            0x12
+#define REG_RX_NB_BYTES          0x13
 #define REG_MODEM_CONFIG_1       0x1D
 #define REG_MODEM_CONFIG_2       0x1E
 #define REG_PREAMBLE_MSB         0x20
@@ -35,50 +43,112 @@
 #define REG_PA_DAC               0x4D
 #define REG_OCP                  0x0B
 
+// Registradores do modo FSK (LongRangeMode = 0): de 0x0D a 0x3F o mapa é
+// outro, com os mesmos endereços dos registradores LoRa
+#define REG_BITRATE_MSB          0x02
+#define REG_BITRATE_LSB          0x03
+#define REG_FDEV_MSB             0x04
+#define REG_FDEV_LSB             0x05
+#define REG_PA_RAMP              0x0A
+#define REG_RX_CONFIG            0x0D
+#define REG_RX_BW                0x12
+#define REG_AFC_BW               0x13
+#define REG_PREAMBLE_DETECT      0x1F
+#define REG_FSK_PREAMBLE_MSB     0x25
+#define REG_FSK_PREAMBLE_LSB     0x26
+#define REG_SYNC_CONFIG          0x27
+#define REG_SYNC_VALUE_1         0x28
+#define REG_PACKET_CONFIG_1      0x30
+#define REG_PACKET_CONFIG_2      0x31
+#define REG_FSK_PAYLOAD_LENGTH   0x32
+#define REG_FIFO_THRESH          0x35
+#define REG_IRQ_FLAGS_2          0x3F
+#define IRQ2_FIFO_OVERRUN        0x10
+#define IRQ2_PACKET_SENT         0x08
+#define IRQ2_PAYLOAD_READY       0x04
+
 // Modos LoRa (mantidos internos)
 #define MODE_SLEEP               0x00
 #define MODE_STDBY               0x01
 #define MODE_TX                  0x03
+#define MODE_RX_CONTINUOUS       0x05
+#define MODE_CAD                 0x07
+#define IRQ_CAD_DETECTED_MASK    0x01
+#define IRQ_CAD_DONE_MASK        0x04
 #define IRQ_TX_DONE_MASK         0x08
+#define IRQ_PAYLOAD_CRC_ERROR_MASK 0x20
+#define IRQ_RX_DONE_MASK         0x40
+
+// Parâmetros do modem: geram os registradores ModemConfig e o tempo no ar
+#define LORA_SF          LORA_SF_MAX // Spreading factor do boot e do beacon
+#define LORA_BW_CODE     7      // ModemConfig1[7:4]: 7 = 125 kHz
+#define LORA_BW_HZ       125000
+#define LORA_CR_CODE     4      // ModemConfig1[3:1]: 4 = 4/8
+#define LORA_PREAMBLE    12     // Símbolos de preâmbulo programados
+
+// Parâmetros do FSK dos despejos: devem ser iguais aos do receptor
+// (software/software/inc/lora_RFM95.c)
+#define FSK_BITRATE_BPS  250000
+#define FSK_FDEV_STEPS   2048   // 125 kHz em passos de Fxosc / 2^19: índice de modulação 1
+#define FSK_RX_BW        0x01   // Mantissa 16, expoente 1: 250 kHz >= Fdev + BR/2
+#define FSK_PREAMBLE     5      // Bytes de preâmbulo
+#define FSK_TX_TIMEOUT_MS 20
+
+static const uint8_t fsk_sync[] = { 0x2D, 0xD4, 0x12 };
+
+// Endereços que lora_fsk_begin() escreve e que o modo LoRa também lê
+// (0x31 é RegDetectOptimize, 0x1F RegSymbTimeoutLsb, 0x40 o mapa dos DIO...):
+// guardados antes do despejo e devolvidos por lora_fsk_end()
+static const uint8_t fsk_shared_regs[] = {
+    REG_BITRATE_MSB, REG_BITRATE_LSB, REG_FDEV_MSB, REG_FDEV_LSB, REG_PA_RAMP,
+    REG_RX_CONFIG, REG_RX_BW, REG_AFC_BW, REG_PREAMBLE_DETECT,
+    REG_FSK_PREAMBLE_MSB, REG_FSK_PREAMBLE_LSB, REG_SYNC_CONFIG,
+    REG_SYNC_VALUE_1, REG_SYNC_VALUE_1 + 1, REG_SYNC_VALUE_1 + 2,
+    REG_PACKET_CONFIG_1, REG_PACKET_CONFIG_2, REG_FSK_PAYLOAD_LENGTH,
+    REG_FIFO_THRESH, REG_DIO_MAPPING_1,
+};
+static uint8_t lora_shared_saved[sizeof(fsk_shared_regs)];
 
-static void busy_wait_ms_local(unsigned int ms);
 static void spi_master_init(void);
 static inline void spi_select(void);
 static inline void spi_deselect(void);
 static inline uint8_t spi_txrx(uint8_t tx_byte);
+static void lora_write_burst(uint8_t reg, const uint8_t *data, uint8_t len);
 static void lora_write_fifo(const uint8_t *data, uint8_t len);
-
-// Cópia local da função busy_wait_ms para evitar dependência externa
-static void busy_wait_ms_local(unsigned int ms) {
-    for (unsigned int i = 0; i < ms; ++i) {
-#ifdef CSR_TIMER0_BASE
-        busy_wait_us(1000);
-#else
-        for(volatile int j = 0; j < 2000; j++);
-#endif
-    }
+static void lora_read_fifo(uint8_t *data, uint8_t len);
+
+static uint8_t lora_sf = LORA_SF;
+static uint8_t lora_implicit_len = 0; // 0: cabeçalho explícito
+static uint8_t lora_channel = LORA_BEACON_CHANNEL;
+static bool lora_fsk = false;         // Modem FSK no lugar do LoRa (despejo)
+static lora_lbt_stats_t lbt_stats;
+static uint64_t lbt_deadline = 0;     // Último início de CAD (timebase_ticks64), 0: sem limite
+
+// Low Data Rate Optimize: obrigatório com símbolo de 16 ms ou mais (SF11 e
+// SF12 em 125 kHz); transmissor e receptor devem concordar
+static uint8_t lora_ldo(uint8_t sf) {
+    return ((1000000ull << sf) / LORA_BW_HZ) >= 16000 ? 1 : 0;
 }
 
-
 // --- Funções SPI (static) ---
 static void spi_master_init(void) {
     spi_cs_write(SPI_MODE_MANUAL | 0x0000);
     #ifdef CSR_SPI_LOOPBACK_ADDR
     spi_loopback_write(0);
     #endif
-    busy_wait_ms_local(1);
+    timebase_delay_ms(1);
 }
 
 static inline void spi_select(void) {
     // mode=manual + sel=1 → CS_N low (active)
     spi_cs_write(SPI_MODE_MANUAL | SPI_CS_MASK);
-    busy_wait_us(2); // Pequeno delay para estabilidade
+    timebase_delay_us(2); // Pequeno delay para estabilidade
 }
 
 static inline void spi_deselect(void) {
     // mode=manual + sel=0 → CS_N high (inactive)
     spi_cs_write(SPI_MODE_MANUAL | 0x0000);
-    busy_wait_us(2); // Pequeno delay para estabilidade
+    timebase_delay_us(2); // Pequeno delay para estabilidade
 }
 
 static inline uint8_t spi_txrx(uint8_t tx_byte) {
@@ -97,15 +167,30 @@ static inline uint8_t spi_txrx(uint8_t tx_byte) {
 }
 
 
-static void lora_write_fifo(const uint8_t *data, uint8_t len) {
+// Registradores consecutivos numa só seleção: o endereço avança sozinho
+// (exceto no FIFO, que recebe todos os bytes)
+static void lora_write_burst(uint8_t reg, const uint8_t *data, uint8_t len) {
     spi_select();
-    spi_txrx(REG_FIFO | 0x80); // Endereço FIFO com bit de escrita
+    spi_txrx(reg | 0x80); // Endereço com bit de escrita
     for (uint8_t i = 0; i < len; i++) {
         spi_txrx(data[i]);
     }
     spi_deselect();
 }
 
+static void lora_write_fifo(const uint8_t *data, uint8_t len) {
+    lora_write_burst(REG_FIFO, data, len);
+}
+
+static void lora_read_fifo(uint8_t *data, uint8_t len) {
+    spi_select();
+    spi_txrx(REG_FIFO & 0x7F); // Endereço FIFO com bit de escrita em 0
+    for (uint8_t i = 0; i < len; i++) {
+        data[i] = spi_txrx(0x00);
+    }
+    spi_deselect();
+}
+
 // Lê registrador (pública)
 uint8_t lora_read_reg(uint8_t reg) {
     uint8_t val;
@@ -124,9 +209,73 @@ void lora_write_reg(uint8_t reg, uint8_t value) {
     spi_deselect();
 }
 
-// Define modo (pública)
+// Define modo (pública); LongRangeMode segue o modem em uso
 void lora_set_mode(uint8_t mode) {
-    lora_write_reg(REG_OP_MODE, (0x80 | mode));
+    lora_write_reg(REG_OP_MODE, (lora_fsk ? 0x00 : 0x80) | mode);
+}
+
+// Troca de canal (pública): RegFrf só muda fora de RX/TX
+void lora_set_channel(uint8_t channel) {
+    const uint32_t frf = lora_channel_frf[channel % LORA_CHANNEL_COUNT];
+    const uint8_t bytes[3] = { (uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf };
+
+    lora_set_mode(MODE_STDBY);
+    lora_write_burst(REG_FRF_MSB, bytes, sizeof(bytes));
+    lora_channel = channel;
+}
+
+// Spreading factor (pública): ModemConfig só muda fora de RX/TX
+void lora_set_sf(uint8_t sf) {
+    if (sf < LORA_SF_MIN) sf = LORA_SF_MIN;
+    if (sf > LORA_SF_MAX) sf = LORA_SF_MAX;
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_MODEM_CONFIG_2, (uint8_t)((sf << 4) | 0x04)); // CRC on
+    lora_write_reg(REG_MODEM_CONFIG_3, (uint8_t)((lora_ldo(sf) << 3) | 0x04)); // AGC on
+    lora_sf = sf;
+}
+
+uint8_t lora_get_sf(void) {
+    return lora_sf;
+}
+
+// Modo de cabeçalho (pública): no implícito o receptor não lê tamanho, CR
+// e CRC do ar; usa RegPayloadLength e a própria configuração
+void lora_set_implicit_header(uint8_t len) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_MODEM_CONFIG_1, (uint8_t)((LORA_BW_CODE << 4) | (LORA_CR_CODE << 1) | (len ? 0x01 : 0x00)));
+    if (len) lora_write_reg(REG_PAYLOAD_LENGTH, len);
+    lora_implicit_len = len;
+}
+
+uint8_t lora_get_implicit_header(void) {
+    return lora_implicit_len;
+}
+
+// Potência no PA_BOOST (pública): 2 a 17 dBm pelo OutputPower; 20 dBm com
+// o PaDac de alta potência
+void lora_set_power(int8_t dbm) {
+    if (dbm >= LORA_POWER_MAX_DBM) {
+        lora_write_reg(REG_PA_CONFIG, 0xFF); // PA_BOOST, MaxPower 7, OutputPower 15
+        lora_write_reg(REG_PA_DAC, 0x87);    // +20 dBm
+        return;
+    }
+    if (dbm > 17) dbm = 17;
+    if (dbm < LORA_POWER_MIN_DBM) dbm = LORA_POWER_MIN_DBM;
+    lora_write_reg(REG_PA_DAC, 0x84);        // Padrão
+    lora_write_reg(REG_PA_CONFIG, (uint8_t)(0xF0 | (dbm - 2)));
+}
+
+// Registradores do modem LoRa (0x0D a 0x3F), no boot e na volta do FSK
+static void lora_modem_config(void) {
+    lora_set_implicit_header(lora_implicit_len); // 0x78 no boot, cabeçalho explícito
+    lora_set_sf(lora_sf);                        // SF12 no boot, CRC on, LDO on, AGC on
+    lora_write_reg(REG_PREAMBLE_MSB, 0x00);
+    lora_write_reg(REG_PREAMBLE_LSB, LORA_PREAMBLE);
+    lora_write_reg(REG_SYNC_WORD, 0x12);    
+    lora_write_reg(REG_FIFO_TX_BASE_ADDR, 0x00);
+    lora_write_reg(REG_FIFO_RX_BASE_ADDR, 0x00);
+    lora_write_reg(REG_IRQ_FLAGS_MASK, 0x00); 
+    lora_write_reg(REG_IRQ_FLAGS, 0xFF); 
 }
 
 // Inicializa LoRa (pública)
@@ -136,8 +285,8 @@ bool lora_init(void) {
     uint8_t rx;
 
     #ifdef CSR_LORA_RESET_BASE
-    lora_reset_out_write(0); busy_wait_ms_local(5);
-    lora_reset_out_write(1); busy_wait_ms_local(10);
+    lora_reset_out_write(0); timebase_delay_ms(5);
+    lora_reset_out_write(1); timebase_delay_ms(10);
     #endif
 
     rx = lora_read_reg(REG_VERSION);
@@ -148,40 +297,88 @@ bool lora_init(void) {
 
     lora_set_mode(MODE_SLEEP);
 
-    uint64_t frf = ((uint64_t)915000000 << 19) / 32000000; // 915 MHz
-    lora_write_reg(REG_FRF_MSB, (uint8_t)(frf >> 16));
-    lora_write_reg(REG_FRF_MID, (uint8_t)(frf >> 8));
-    lora_write_reg(REG_FRF_LSB, (uint8_t)(frf >> 0));
-    printf("Frequencia lora configurada para 915 MHz\n");
-
-    lora_write_reg(REG_PA_CONFIG, 0xFF);
-    lora_write_reg(REG_PA_DAC, 0x87);    
-    lora_write_reg(REG_MODEM_CONFIG_1, 0x78); 
-    lora_write_reg(REG_MODEM_CONFIG_2, 0xC4); 
-    lora_write_reg(REG_MODEM_CONFIG_3, 0x0C); 
-    lora_write_reg(REG_PREAMBLE_MSB, 0x00);
-    lora_write_reg(REG_PREAMBLE_LSB, 0x0C); 
-    lora_write_reg(REG_SYNC_WORD, 0x12);    
+    lora_set_channel(LORA_BEACON_CHANNEL);
+    printf("Frequencia lora configurada para %lu kHz (canal %u de %u)\n",
+           (unsigned long)(LORA_CHANNEL_HZ(LORA_BEACON_CHANNEL) / 1000), LORA_BEACON_CHANNEL, LORA_CHANNEL_COUNT);
+
+    lora_set_power(LORA_POWER_MAX_DBM);
     lora_write_reg(REG_OCP, 0x37);       
-    lora_write_reg(REG_FIFO_TX_BASE_ADDR, 0x00);
-    lora_write_reg(REG_FIFO_RX_BASE_ADDR, 0x00);
     lora_write_reg(REG_LNA, 0x23);       
-    lora_write_reg(REG_IRQ_FLAGS_MASK, 0x00); 
-    lora_write_reg(REG_IRQ_FLAGS, 0xFF); 
+    lora_modem_config();
 
     lora_set_mode(MODE_STDBY);
-    busy_wait_ms_local(10);
+    timebase_delay_ms(10);
 
-    printf("Modulacao: BW=62.5kHz, SF=12, CR=4/8, Preamble=12, SyncWord=0x12\n");
+    printf("Modulacao: BW=125kHz, SF=12, CR=4/8, Preamble=12, SyncWord=0x12\n");
 
     return true;
 }
 
 
+// Um CAD: true se havia preâmbulo LoRa no canal. O rádio volta sozinho
+// para standby ao terminar.
+static bool lora_channel_busy(void) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_IRQ_FLAGS, IRQ_CAD_DONE_MASK | IRQ_CAD_DETECTED_MASK);
+    lora_set_mode(MODE_CAD);
+
+    uint8_t flags = 0;
+    const uint32_t timeout = (lora_cad_time_us() + 1000) * TIMEBASE_TICKS_PER_US;
+    const uint32_t start = timebase_ticks();
+    while (timebase_ticks() - start < timeout) {
+        flags = lora_read_reg(REG_IRQ_FLAGS);
+        if (flags & IRQ_CAD_DONE_MASK) break;
+    }
+    lora_write_reg(REG_IRQ_FLAGS, IRQ_CAD_DONE_MASK | IRQ_CAD_DETECTED_MASK);
+    lora_set_mode(MODE_STDBY);
+
+    lbt_stats.cad_runs++;
+    return (flags & IRQ_CAD_DETECTED_MASK) != 0;
+}
+
+// Espera o canal livre com backoff exponencial aleatório. Nenhum CAD
+// começa depois de lbt_deadline: o envio invadiria o slot seguinte.
+static bool lora_listen_before_talk(void) {
+    uint32_t busy = 0;
+
+    for (uint32_t attempt = 0; attempt < LORA_LBT_MAX_ATTEMPTS; attempt++) {
+        if (lbt_deadline && timebase_ticks64() > lbt_deadline) break;
+        if (!lora_channel_busy()) return true;
+        lbt_stats.channel_busy++;
+        busy++;
+
+        if (attempt + 1 == LORA_LBT_MAX_ATTEMPTS) break;
+
+        const uint32_t exp = attempt < LORA_LBT_BACKOFF_MAX_EXP ? attempt : LORA_LBT_BACKOFF_MAX_EXP;
+        // Sorteado: espalha os backoffs de nós que ouviram a mesma portadora
+        const uint32_t wait_ms = 1 + prng_next() % (LORA_LBT_BACKOFF_MS << exp);
+        if (lbt_deadline && timebase_ticks64() + (uint64_t)wait_ms * TIMEBASE_TICKS_PER_MS > lbt_deadline) break;
+        TRACE_INFO(LORA_CAD_BUSY, (int16_t)(attempt + 1), (int32_t)wait_ms);
+        lbt_stats.retries++;
+        timebase_delay_ms(wait_ms);
+    }
+
+    lbt_stats.abandoned++;
+    TRACE_WARN(LORA_LBT_GAVE_UP, (int16_t)busy, (int32_t)lbt_stats.abandoned);
+    return false;
+}
+
+lora_lbt_stats_t lora_get_lbt_stats(void) {
+    return lbt_stats;
+}
+
+void lora_set_lbt_deadline(uint64_t deadline) {
+    lbt_deadline = deadline;
+}
+
 // Envia bytes (pública)
 bool lora_send_bytes(const uint8_t *data, size_t len) {
     if (len == 0 || len > 255) {
-        printf("Erro LoRa: Tamanho do pacote inválido (%d bytes)\n", (int)len);
+        TRACE_ERROR(LORA_BAD_LEN, 0, (int32_t)len);
+        return false;
+    }
+
+    if (LORA_LBT_ENABLE && !lora_listen_before_talk()) {
         return false;
     }
 
@@ -194,8 +391,10 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
     lora_write_reg(REG_IRQ_FLAGS, 0xFF);
     lora_write_reg(REG_DIO_MAPPING_1, 0x40);
 
-    printf("Enviando %d bytes via LoRa...\n", (int)len);
+    TRACE_DEBUG(LORA_TX_START, (int16_t)len, 0);
 
+    const uint32_t tx_start = timebase_ticks();
+    (void)tx_start; // Sem uso com TRACE_LEVEL abaixo de INFO
     lora_set_mode(MODE_TX);
 
     int timeout_cnt = TX_TIMEOUT_MS;
@@ -203,14 +402,165 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
         if (lora_read_reg(REG_IRQ_FLAGS) & IRQ_TX_DONE_MASK) {
             lora_write_reg(REG_IRQ_FLAGS, IRQ_TX_DONE_MASK);
             lora_set_mode(MODE_STDBY);
-            printf("Pacote enviado com sucesso!\n");
+            TRACE_INFO(LORA_TX_DONE, 0, (int32_t)((timebase_ticks() - tx_start) / TIMEBASE_TICKS_PER_MS));
             return true;
         }
-        busy_wait_ms_local(1);
+        timebase_delay_ms(1);
         timeout_cnt--;
     }
 
-    printf("Erro: Timeout de TX! O radio foi resetado para Standby.\n");
+    TRACE_ERROR(LORA_TX_TIMEOUT, 0, 0);
     lora_set_mode(MODE_STDBY);
     return false; 
-}
\ No newline at end of file
+}
+
+// Coloca o rádio em recepção contínua (pública)
+void lora_start_rx_continuous(void) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_FIFO_ADDR_PTR, 0x00);
+    lora_write_reg(REG_IRQ_FLAGS, 0xFF);
+    lora_write_reg(REG_DIO_MAPPING_1, 0x00); // DIO0 -> RxDone
+    lora_set_mode(MODE_RX_CONTINUOUS);
+}
+
+// Sem pino de interrupção no FPGA: consulta RegIrqFlags (pública)
+int lora_receive_bytes(uint8_t *buf, size_t maxlen) {
+    uint8_t irq_flags = lora_read_reg(REG_IRQ_FLAGS);
+    if (!(irq_flags & IRQ_RX_DONE_MASK)) return 0;
+    lora_write_reg(REG_IRQ_FLAGS, 0xFF);
+
+    if (irq_flags & IRQ_PAYLOAD_CRC_ERROR_MASK) {
+        TRACE_WARN(LORA_RX_CRC_ERROR, 0, 0);
+        return 0;
+    }
+
+    uint8_t len = lora_read_reg(REG_RX_NB_BYTES);
+    if (len > maxlen) len = (uint8_t)maxlen;
+
+    lora_write_reg(REG_FIFO_ADDR_PTR, lora_read_reg(REG_FIFO_RX_CURRENT_ADDR));
+    lora_read_fifo(buf, len);
+    return len;
+}
+
+// Tempo no ar de um pacote, fórmula da seção 4.1.1.7 do datasheet SX1276 (pública)
+uint32_t lora_time_on_air_us(size_t len) {
+    const uint32_t symbol_us = (uint32_t)((1000000ull << lora_sf) / LORA_BW_HZ);
+
+    // Preâmbulo: programado + 4.25 símbolos
+    uint32_t preamble_us = (LORA_PREAMBLE * 4 + 17) * symbol_us / 4;
+
+    // Payload com CRC ligado; o cabeçalho explícito (IH = 0) custa 20 bits
+    const int32_t ih = lora_implicit_len ? 1 : 0;
+    int32_t num = 8 * (int32_t)len - 4 * lora_sf + 28 + 16 - 20 * ih;
+    int32_t den = 4 * (lora_sf - 2 * lora_ldo(lora_sf));
+    int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+    uint32_t payload_symbols = 8 + (uint32_t)blocks * (LORA_CR_CODE + 4);
+
+    return preamble_us + payload_symbols * symbol_us;
+}
+
+// Duração de um CAD com o SF configurado (pública)
+uint32_t lora_cad_time_us(void) {
+    return CAD_SYMBOLS * (uint32_t)((1000000ull << lora_sf) / LORA_BW_HZ);
+}
+
+// ============================
+// === FSK (despejos) ===
+// ============================
+
+// LongRangeMode só muda em sleep (pública)
+void lora_fsk_begin(void) {
+    const uint32_t frf = LORA_FRF(FSK_BULK_HZ);
+    const uint8_t frf_bytes[3] = { (uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf };
+    const uint16_t bitrate = LORA_FXOSC_HZ / FSK_BITRATE_BPS;
+
+    lora_set_mode(MODE_SLEEP);
+    for (size_t i = 0; i < sizeof(fsk_shared_regs); i++)
+        lora_shared_saved[i] = lora_read_reg(fsk_shared_regs[i]);
+    lora_fsk = true;
+    lora_set_mode(MODE_SLEEP);
+
+    lora_write_burst(REG_FRF_MSB, frf_bytes, sizeof(frf_bytes));
+    lora_write_reg(REG_BITRATE_MSB, (uint8_t)(bitrate >> 8));
+    lora_write_reg(REG_BITRATE_LSB, (uint8_t)bitrate);
+    lora_write_reg(REG_FDEV_MSB, (uint8_t)(FSK_FDEV_STEPS >> 8));
+    lora_write_reg(REG_FDEV_LSB, (uint8_t)FSK_FDEV_STEPS);
+    lora_write_reg(REG_PA_RAMP, 0x49);          // Gaussiano BT 0.5, rampa de 40 us
+    lora_write_reg(REG_RX_CONFIG, 0x1E);        // AFC e AGC automáticos, RX dispara no preâmbulo
+    lora_write_reg(REG_RX_BW, FSK_RX_BW);
+    lora_write_reg(REG_AFC_BW, FSK_RX_BW);
+    lora_write_reg(REG_PREAMBLE_DETECT, 0xAA);  // Detector ligado, 2 bytes
+    lora_write_reg(REG_FSK_PREAMBLE_MSB, 0x00);
+    lora_write_reg(REG_FSK_PREAMBLE_LSB, FSK_PREAMBLE);
+    lora_write_reg(REG_SYNC_CONFIG, (uint8_t)(0x50 | (sizeof(fsk_sync) - 1))); // Reinício automático do RX
+    lora_write_burst(REG_SYNC_VALUE_1, fsk_sync, sizeof(fsk_sync));
+    lora_write_reg(REG_PACKET_CONFIG_1, 0xD0);  // Tamanho variável, whitening, CRC
+    lora_write_reg(REG_PACKET_CONFIG_2, 0x40);  // Modo pacote
+    lora_write_reg(REG_FSK_PAYLOAD_LENGTH, LORA_FSK_MAX_LEN); // Maior pacote aceito
+    lora_write_reg(REG_FIFO_THRESH, 0x8F);      // TX começa com o FIFO não vazio
+    lora_write_reg(REG_DIO_MAPPING_1, 0x00);
+    lora_set_mode(MODE_STDBY);
+}
+
+void lora_fsk_end(void) {
+    lora_set_mode(MODE_SLEEP);
+    lora_fsk = false;
+    lora_set_mode(MODE_SLEEP);
+    for (size_t i = 0; i < sizeof(fsk_shared_regs); i++)
+        lora_write_reg(fsk_shared_regs[i], lora_shared_saved[i]);
+    lora_modem_config();
+    lora_set_channel(lora_channel);
+}
+
+bool lora_fsk_send(const uint8_t *data, size_t len) {
+    if (len == 0 || len > LORA_FSK_MAX_LEN) {
+        TRACE_ERROR(LORA_BAD_LEN, 0, (int32_t)len);
+        return false;
+    }
+
+    // Sem LBT: o despejo só acontece dentro do slot do próprio nó
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_IRQ_FLAGS_2, IRQ2_FIFO_OVERRUN); // Esvazia o FIFO
+    lora_write_reg(REG_FIFO, (uint8_t)len);
+    lora_write_fifo(data, (uint8_t)len);
+    lora_set_mode(MODE_TX);
+
+    const uint32_t start = timebase_ticks();
+    while (timebase_ticks() - start < FSK_TX_TIMEOUT_MS * TIMEBASE_TICKS_PER_MS) {
+        if (lora_read_reg(REG_IRQ_FLAGS_2) & IRQ2_PACKET_SENT) {
+            lora_set_mode(MODE_STDBY);
+            return true;
+        }
+    }
+
+    TRACE_ERROR(LORA_TX_TIMEOUT, 0, 0);
+    lora_set_mode(MODE_STDBY);
+    return false;
+}
+
+void lora_fsk_start_rx(void) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_IRQ_FLAGS_2, IRQ2_FIFO_OVERRUN);
+    lora_set_mode(MODE_RX_CONTINUOUS);
+}
+
+// PayloadReady só sobe com o CRC certo; o FIFO começa pelo byte de tamanho
+int lora_fsk_receive(uint8_t *buf, size_t maxlen) {
+    if (!(lora_read_reg(REG_IRQ_FLAGS_2) & IRQ2_PAYLOAD_READY)) return 0;
+
+    uint8_t len = lora_read_reg(REG_FIFO);
+    if (len > LORA_FSK_MAX_LEN) len = LORA_FSK_MAX_LEN;
+    if (len > maxlen) {
+        uint8_t discard[LORA_FSK_MAX_LEN];
+        lora_read_fifo(discard, len);
+        return 0;
+    }
+    lora_read_fifo(buf, len);
+    return len;
+}
+
+// Preâmbulo, sync, tamanho, payload e CRC, bit a bit
+uint32_t lora_fsk_time_on_air_us(size_t len) {
+    const uint32_t bits = 8 * (FSK_PREAMBLE + sizeof(fsk_sync) + 1 + (uint32_t)len + 2);
+    return (uint32_t)((uint64_t)bits * 1000000 / FSK_BITRATE_BPS);
+}
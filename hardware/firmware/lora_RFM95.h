@@ -6,6 +6,48 @@
 #include <stdbool.h>
 #include <stddef.h> // Para size_t
 
+// ============================
+// === Listen-before-talk ===
+// ============================
+// Antes de cada envio o rádio faz um Channel Activity Detection (CAD). Com
+// preâmbulo LoRa no ar, espera um tempo aleatório numa janela que dobra a
+// cada tentativa e tenta de novo. Ajustável por -D na compilação.
+#ifndef LORA_LBT_ENABLE
+#define LORA_LBT_ENABLE 1        // make LBT=0 desliga
+#endif
+#ifndef LORA_LBT_MAX_ATTEMPTS
+#define LORA_LBT_MAX_ATTEMPTS 4  // CADs antes de desistir do envio
+#endif
+#ifndef LORA_LBT_BACKOFF_MS
+#define LORA_LBT_BACKOFF_MS 20   // Janela de espera após o primeiro CAD ocupado
+#endif
+#ifndef LORA_LBT_BACKOFF_MAX_EXP
+#define LORA_LBT_BACKOFF_MAX_EXP 3 // Janela máxima: LORA_LBT_BACKOFF_MS << 3
+#endif
+
+// ============================
+// === Taxa e Potência ===
+// ============================
+// Faixas aceitas por lora_set_sf() e lora_set_power(). O boot e o beacon
+// usam LORA_SF_MAX e LORA_POWER_MAX_DBM, o enlace mais robusto.
+#define LORA_SF_MIN        7
+#define LORA_SF_MAX        12
+#define LORA_POWER_MIN_DBM 2
+#define LORA_POWER_MAX_DBM 20
+
+// Maior pacote FSK: o FIFO do modo FSK tem 64 bytes, com o byte de tamanho
+#define LORA_FSK_MAX_LEN 63
+
+/**
+ * @brief Contadores do listen-before-talk desde o boot.
+ */
+typedef struct {
+    uint32_t cad_runs;     // CADs executados
+    uint32_t channel_busy; // CADs que acharam o canal ocupado (colisões evitadas)
+    uint32_t retries;      // Esperas de backoff
+    uint32_t abandoned;    // Envios cancelados após LORA_LBT_MAX_ATTEMPTS
+} lora_lbt_stats_t;
+
 // ============================
 // === Funções Públicas ===
 // ============================
@@ -17,14 +59,133 @@
  */
 bool lora_init(void);
 
+/**
+ * @brief Sintoniza um canal do plano (lora_channels.h).
+ * Escreve os três bytes de RegFrf numa só transação SPI e deixa o rádio em
+ * standby; quem estava recebendo deve chamar lora_start_rx_continuous().
+ * @param channel Canal, 0 .. LORA_CHANNEL_COUNT-1.
+ */
+void lora_set_channel(uint8_t channel);
+
+/**
+ * @brief Troca o spreading factor (BW e CR não mudam). Também ajusta o Low
+ * Data Rate Optimize e o tempo no ar de lora_time_on_air_us(). Deixa o
+ * rádio em standby.
+ * @param sf LORA_SF_MIN .. LORA_SF_MAX.
+ */
+void lora_set_sf(uint8_t sf);
+
+/**
+ * @brief Spreading factor em uso.
+ */
+uint8_t lora_get_sf(void);
+
+/**
+ * @brief Troca o modo de cabeçalho LoRa. No implícito o pacote vai sem o
+ * cabeçalho de tamanho/CR/CRC (20 bits a menos no ar) e o receptor precisa
+ * saber o tamanho antes: os dois lados devem estar no mesmo modo. Deixa o
+ * rádio em standby.
+ * @param len Tamanho fixo dos pacotes (RegPayloadLength); 0: explícito.
+ */
+void lora_set_implicit_header(uint8_t len);
+
+/**
+ * @brief Tamanho do cabeçalho implícito em uso; 0: explícito.
+ */
+uint8_t lora_get_implicit_header(void);
+
+/**
+ * @brief Potência de transmissão no PA_BOOST.
+ * @param dbm LORA_POWER_MIN_DBM .. LORA_POWER_MAX_DBM; 18 e 19 viram 17.
+ */
+void lora_set_power(int8_t dbm);
+
 /**
  * @brief Envia um buffer de bytes via LoRa.
  * @param data Ponteiro para o buffer de dados a ser enviado.
  * @param len Número de bytes a serem enviados (máximo 255).
- * @return true se o pacote foi enviado com sucesso (TxDone recebido), false em caso de erro ou timeout.
+ * Com LORA_LBT_ENABLE o canal é verificado (CAD) antes, com backoff.
+ * @return true se o pacote foi enviado com sucesso (TxDone recebido), false em caso de erro,
+ * timeout ou canal ocupado em todas as tentativas.
  */
 bool lora_send_bytes(const uint8_t *data, size_t len);
 
+/**
+ * @brief Contadores do listen-before-talk.
+ */
+lora_lbt_stats_t lora_get_lbt_stats(void);
+
+/**
+ * @brief Limita o LBT dos próximos envios: depois desse instante nenhum
+ * CAD começa e nenhum backoff é esperado; o envio é abandonado.
+ * tdma_wait_slot() define o último ponto em que a troca ainda termina
+ * dentro do slot.
+ * @param deadline Instante em timebase_ticks64(); 0 sem limite.
+ */
+void lora_set_lbt_deadline(uint64_t deadline);
+
+/**
+ * @brief Coloca o rádio em recepção contínua (DIO0 -> RxDone).
+ */
+void lora_start_rx_continuous(void);
+
+/**
+ * @brief Verifica se chegou um pacote e o copia para o buffer. Não bloqueia.
+ * Pacotes com erro de CRC são descartados.
+ * @param buf Buffer de destino.
+ * @param maxlen Tamanho do buffer; pacotes maiores são truncados.
+ * @return Número de bytes recebidos, ou 0 se nenhum pacote chegou.
+ */
+int lora_receive_bytes(uint8_t *buf, size_t maxlen);
+
+/**
+ * @brief Tempo no ar de um pacote com a modulação configurada.
+ * @param len Tamanho do payload em bytes.
+ * @return Duração da transmissão em microssegundos, preâmbulo incluído.
+ */
+uint32_t lora_time_on_air_us(size_t len);
+
+/**
+ * @brief Duração de um CAD (Channel Activity Detection) com o SF configurado.
+ */
+uint32_t lora_cad_time_us(void);
+
+/**
+ * @brief Troca o modem para FSK (LongRangeMode = 0) no canal dos despejos
+ * (FSK_BULK_HZ): 250 kbps, pacotes de tamanho variável até
+ * LORA_FSK_MAX_LEN com CRC e whitening. As funções LoRa não valem até
+ * lora_fsk_end(). Deixa o rádio em standby.
+ */
+void lora_fsk_begin(void);
+
+/**
+ * @brief Volta ao modem LoRa com o canal, o SF e o modo de cabeçalho de
+ * antes do FSK. Deixa o rádio em standby.
+ */
+void lora_fsk_end(void);
+
+/**
+ * @brief Envia um pacote FSK e espera o PacketSent (poucos ms), sem LBT.
+ * @return true se o pacote saiu.
+ */
+bool lora_fsk_send(const uint8_t *data, size_t len);
+
+/**
+ * @brief Coloca o rádio em recepção FSK contínua.
+ */
+void lora_fsk_start_rx(void);
+
+/**
+ * @brief Verifica se chegou um pacote FSK com CRC correto.
+ * @return Tamanho do pacote, ou 0 se nada chegou (ou não coube em maxlen).
+ */
+int lora_fsk_receive(uint8_t *buf, size_t maxlen);
+
+/**
+ * @brief Tempo no ar de um pacote FSK, preâmbulo e CRC incluídos.
+ */
+uint32_t lora_fsk_time_on_air_us(size_t len);
+
 /**
  * @brief Coloca o rádio LoRa em um modo de operação específico.
  * (Ex: Sleep, Standby, TX, RX contínuo)
@@ -51,4 +212,4 @@ uint8_t lora_read_reg(uint8_t reg);
 void lora_write_reg(uint8_t reg, uint8_t value);
 
 
-#endif // LORA_RFM95_H_
\ No newline at end of file
+#endif // LORA_RFM95_H_
@@ -17,63 +17,301 @@
 
 #include "aht10.h"      // Biblioteca do sensor AHT10
 #include "lora_RFM95.h" // Biblioteca do módulo LoRa"
+#include "lora_frame.h"  // Cabeçalho dos quadros (igual ao do receptor)
+#include "tdma.h"        // Slots sincronizados pelo beacon do receptor
+#include "arq.h"         // Envio confirmado com ACK seletivo
+#include "fec_tx.h"      // Paridade entre quadros (sem ARQ)
+#include "airtime.h"     // Orçamento de tempo no ar (token bucket)
+#include "adr.h"         // Taxa e potência comandadas pelo gateway
+#include "bulk.h"        // Log de leituras e despejo em FSK
+#include "prng.h"        // Sorteios do nó: jitter do envio e backoff do LBT
+#include "timebase.h"
+#include "trace.h"
 
 // ==========================================================
 // ===                 DEFINIÇÕES GLOBAIS                 ===
 // ==========================================================
-#define LORA_FREQUENCY 915.0f         // Frequência (MHz) — US915 para Brasil
-#define SENSOR_SEND_INTERVAL_MS 10000 // Intervalo entre envios (10s)
+// Frequências: plano de canais e saltos em lora_channels.h (igual ao do receptor)
+
+// Um envio por superquadro TDMA: o intervalo é definido pelo beacon do
+// receptor (slot_ms * slot_count), não mais por um atraso fixo
+
+// Identificação deste nó na rede (make NODE_ID=n), de 1 a 254
+#ifndef NODE_ID
+#define NODE_ID 1
+#endif
+// 0 cairia no slot do beacon em frame_tdma_slot() e 255 é o broadcast
+_Static_assert(NODE_ID > FRAME_NODE_GATEWAY && NODE_ID < FRAME_NODE_BROADCAST, "NODE_ID deve ficar entre 1 e 254");
+
+// Envio confirmado (make ARQ=0 volta ao envio simples, sem ACK)
+#ifndef ARQ_ENABLE
+#define ARQ_ENABLE 1
+#endif
+
+// Paridade no envio simples (make FEC_K=k FEC_M=m): a cada k quadros de
+// dados seguem m de paridade, e o receptor recupera até m perdidos do
+// grupo. FEC_K=0 desliga.
+#ifndef FEC_K
+#define FEC_K 0
+#endif
+#ifndef FEC_M
+#define FEC_M 1
+#endif
+#if FEC_K > FRAME_FEC_MAX_K || FEC_M < 1 || FEC_M > FRAME_FEC_MAX_M
+#error "FEC_K ou FEC_M fora dos limites de lora_frame.h"
+#endif
+
+// Cabeçalho implícito nos quadros de sensor (make IMPLICIT=0 desliga): o
+// nó anuncia FRAME_FLAG_IMPLICIT e passa ao modo implícito quando o beacon
+// marca o seu slot. Só no envio simples sem paridade, o único em que todo
+// quadro tem o mesmo tamanho.
+#ifndef IMPLICIT_ENABLE
+#define IMPLICIT_ENABLE 1
+#endif
+#define IMPLICIT_HEADER (IMPLICIT_ENABLE && !ARQ_ENABLE && !FEC_K)
+
+// Log das leituras, despejado em FSK quando o gateway concede no ACK
+// (make BULK=0 desliga). Só com ARQ: a concessão vem no ACK.
+#ifndef BULK_ENABLE
+#define BULK_ENABLE 1
+#endif
+
+// Superquadros entre relatórios dos contadores do nó no trace
+#define STATS_REPORT_SUPERFRAMES 16
+
+// Sequência do próximo quadro; o primeiro após o boot leva FRAME_FLAG_RESET
+static uint16_t tx_seq = 0;
+static bool tx_first_frame = true;
+
+// Superquadros entre amostras, ajustado pelo gateway nos ACKs
+static uint8_t sample_interval = 1;
+static uint8_t superframes_since_sample = 0;
+static uint8_t superframes_since_report = 0;
 
 // ==========================================================
 // ===                PROTÓTIPOS DE FUNÇÃO                ===
 // ==========================================================
 static void transmit_sensor_data(void);
-static void delay_ms(unsigned int ms);
+static void transmit_sensor_batch(void);
+static void transmit_fec_parity(void);
+static bool airtime_allows(uint32_t airtime_us);
 
 // ==========================================================
-// ===               UTILITÁRIOS DE TEMPO                 ===
+// ===              ROTINA DE TRANSMISSÃO LoRa            ===
 // ==========================================================
-// Busy-wait simples em milissegundos
-static void delay_ms(unsigned int ms)
+// Sem saldo no balde o envio fica para um próximo slot
+static bool airtime_allows(uint32_t airtime_us)
 {
-    for (unsigned int i = 0; i < ms; ++i)
+    if (airtime_request(airtime_us))
     {
-#ifdef CSR_TIMER0_BASE
-        busy_wait_us(1000);
-#else
-        for (volatile int j = 0; j < 2000; j++)
-            ;
-#endif
+        return true;
     }
+    TRACE_WARN(AIRTIME_DEFERRED, (int16_t)(airtime_get_stats().balance_us / 1000), airtime_us);
+    return false;
 }
 
-// ==========================================================
-// ===              ROTINA DE TRANSMISSÃO LoRa            ===
-// ==========================================================
-// Lê os dados do sensor AHT10 e envia via LoRa
+// Contador desde o boot no argumento de 16 bits do trace, saturado
+static int16_t stat16(uint32_t count)
+{
+    return count > INT16_MAX ? INT16_MAX : (int16_t)count;
+}
+
+// Relatório periódico dos contadores do nó, no nível padrão do trace
+static void report_stats(void)
+{
+    const airtime_stats_t airtime = airtime_get_stats();
+    TRACE_STATS(AIRTIME_USAGE, (int16_t)airtime.used_permille, airtime.deferred);
+
+    if (LORA_LBT_ENABLE)
+    {
+        const lora_lbt_stats_t lbt = lora_get_lbt_stats();
+        TRACE_STATS(LBT_CADS, stat16(lbt.channel_busy), lbt.cad_runs);
+        TRACE_STATS(LBT_RETRIES, stat16(lbt.abandoned), lbt.retries);
+    }
+
+    if (ARQ_ENABLE)
+    {
+        const arq_stats_t arq = arq_get_stats();
+        TRACE_STATS(ARQ_DELIVERY, stat16(arq.ack_timeouts), arq.acked);
+        TRACE_STATS(ARQ_LOSS, stat16(arq.dropped_retries + arq.dropped_overflow), arq.retransmitted);
+    }
+}
+
+// Lê os dados do sensor AHT10 e envia via LoRa no slot deste nó
 static void transmit_sensor_data(void)
 {
     sensor_data_T sensor_data; // Struct definida em aht10.h
-    printf("Lendo dados do sensor AHT10...\n");
+    frame_sensor_t frame;
+
+    // O modo vale até o próximo beacon, que é sempre explícito
+    const bool implicit = IMPLICIT_HEADER && tdma_slot_implicit();
+    lora_set_implicit_header(implicit ? FRAME_IMPLICIT_LEN : 0);
+    const uint32_t airtime_us = lora_time_on_air_us(sizeof(frame));
+
+    // Leitura adiada não faz falta: a do próximo slot é mais recente
+    if (!airtime_allows(airtime_us))
+    {
+        return;
+    }
 
+    // Nada de printf aqui: os eventos vão para o anel de trace e só são
+    // enviados à UART com o firmware ocioso (trace_flush)
     if (aht10_get_data(&sensor_data))
     {
-        printf("  Temperatura: %d.%02d C\n",
-               sensor_data.temperatura / 100,
-               abs(sensor_data.temperatura) % 100);
+        TRACE_INFO(SENSOR_READ, sensor_data.temperatura, sensor_data.umidade);
+
+        frame.header.node_id = NODE_ID;
+        frame.header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_SENSOR,
+            (tx_first_frame ? FRAME_FLAG_RESET : 0) | (FEC_K ? FRAME_FLAG_FEC : 0) |
+            (IMPLICIT_HEADER ? FRAME_FLAG_IMPLICIT : 0));
+        frame.header.seq = tx_seq;
+        frame.temperatura = sensor_data.temperatura;
+        frame.umidade = sensor_data.umidade;
+
+        // Leitura feita logo após o beacon; o envio espera o slot
+        if (!tdma_wait_slot(airtime_us / 1000 + 1))
+        {
+            return;
+        }
+
+        // A sequência avança mesmo se o envio falhar: o receptor conta a
+        // lacuna, e a paridade do grupo ainda pode recuperar o quadro
+        tx_seq++;
+        tx_first_frame = false;
+        if (FEC_K)
+        {
+            fec_tx_add((const uint8_t *)&frame, sizeof(frame));
+        }
+        if (lora_send_bytes((uint8_t *)&frame, sizeof(frame)))
+        {
+            airtime_charge(airtime_us);
+        }
+        else
+        {
+            TRACE_WARN(LORA_TX_ERROR, 0, 0);
+        }
+    }
+    else
+    {
+        TRACE_WARN(SENSOR_FAIL, 0, 0);
+    }
+}
+
+// Fecha o grupo: cada linha de paridade ocupa o slot de um quadro de dados
+static void transmit_fec_parity(void)
+{
+    frame_parity_t frame;
+
+    // O tamanho só é conhecido depois de montar; reserva o pior caso do grupo.
+    // Sem saldo, a paridade continua pendente para o próximo slot.
+    const uint32_t max_airtime_us = lora_time_on_air_us(FRAME_PARITY_LEN(1 + sizeof(frame_sensor_t)));
+    if (!airtime_allows(max_airtime_us) || !tdma_wait_slot(max_airtime_us / 1000 + 1))
+    {
+        return;
+    }
+
+    const size_t len = fec_tx_next_parity(&frame, NODE_ID);
+    TRACE_DEBUG(FEC_PARITY, frame.row, frame.header.seq);
+    if (lora_send_bytes((uint8_t *)&frame, len))
+    {
+        airtime_charge(lora_time_on_air_us(len));
+    }
+    else
+    {
+        TRACE_WARN(LORA_TX_ERROR, 0, 0);
+    }
+}
 
-        printf("  Umidade: %d.%02d %%\n",
-               sensor_data.umidade / 100,
-               abs(sensor_data.umidade) % 100);
+// Com ARQ: amostras vão para a fila e saem em lote, com pedido de ACK.
+// As não confirmadas seguem no próximo slot junto com as novas.
+static void transmit_sensor_batch(void)
+{
+    sensor_data_T sensor_data;
+    frame_batch_t frame;
+    frame_ack_t ack;
 
-        if (!lora_send_bytes((uint8_t *)&sensor_data, sizeof(sensor_data)))
+    if (++superframes_since_sample >= sample_interval)
+    {
+        superframes_since_sample = 0;
+        if (aht10_get_data(&sensor_data))
         {
-            printf("Erro durante o envio via LoRa (verificar log da biblioteca).\n");
+            TRACE_INFO(SENSOR_READ, sensor_data.temperatura, sensor_data.umidade);
+            const uint16_t sample_seq = arq_push(sensor_data.temperatura, sensor_data.umidade);
+            if (BULK_ENABLE)
+            {
+                bulk_log(sample_seq, sensor_data.temperatura, sensor_data.umidade);
+            }
+        }
+        else
+        {
+            TRACE_WARN(SENSOR_FAIL, 0, 0);
+        }
+    }
+
+    if (arq_pending() == 0)
+    {
+        return;
+    }
+
+    // Sem saldo as amostras esperam na fila e saem juntas num lote maior,
+    // que custa menos tempo no ar por amostra
+    const uint32_t airtime_us = lora_time_on_air_us(arq_frame_len());
+    if (!airtime_allows(airtime_us))
+    {
+        return;
+    }
+
+    // O slot reserva o quadro e a janela do ACK
+    const uint32_t busy_ms = airtime_us / 1000 + 1 + arq_ack_window_ms();
+    if (!tdma_wait_slot(busy_ms))
+    {
+        return;
+    }
+
+    const size_t len = arq_build(&frame);
+    frame.header.node_id = NODE_ID;
+    frame.header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_BATCH,
+        FRAME_FLAG_ACK_REQ | (tx_first_frame ? FRAME_FLAG_RESET : 0) |
+        (BULK_ENABLE && bulk_wanted() ? FRAME_FLAG_BULK : 0));
+    frame.header.seq = tx_seq++;
+    frame.adr = adr_report();
+    frame.reserved = 0;
+    tx_first_frame = false;
+
+    if (!lora_send_bytes((uint8_t *)&frame, len))
+    {
+        TRACE_WARN(LORA_TX_ERROR, 0, 0);
+        arq_complete(NULL);
+        return;
+    }
+    airtime_charge(airtime_us);
+
+    if (arq_wait_ack(NODE_ID, frame.header.seq, &ack))
+    {
+        arq_complete(&ack);
+        adr_on_ack(&ack);
+        TRACE_INFO(ARQ_ACK, arq_pending(), ack.base_seq);
+
+        // Configuração de carona no ACK
+        if (ack.interval != 0 && ack.interval != sample_interval)
+        {
+            sample_interval = ack.interval;
+            TRACE_INFO(ARQ_INTERVAL, sample_interval, 0);
+        }
+
+        // Despejo concedido: o resto do slot é do FSK
+        if (BULK_ENABLE && (FRAME_FLAGS(&ack.header) & FRAME_FLAG_BULK))
+        {
+            const uint32_t fragments = bulk_get_stats().fragments;
+            bulk_transfer(NODE_ID, tdma_slot_end());
+            // O FSK também conta no orçamento, com fragmentos cheios
+            airtime_charge((bulk_get_stats().fragments - fragments) * lora_fsk_time_on_air_us(sizeof(frame_bulk_t)));
         }
     }
     else
     {
-        printf("Falha na leitura do sensor AHT10. Envio cancelado.\n");
+        arq_complete(NULL);
+        adr_on_ack_timeout();
     }
 }
 
@@ -85,16 +323,10 @@ int main(void)
 #endif
     uart_init();
 
-// Inicializa timer0 se presente
-#ifdef CSR_TIMER0_BASE
-    timer0_en_write(0);
-    timer0_reload_write(0);
-    timer0_load_write(CONFIG_CLOCK_FREQUENCY / 1000000);
-    timer0_en_write(1);
-    timer0_update_value_write(1);
-#endif
+    // Timer0 em contagem livre: base das esperas e dos timestamps do trace
+    timebase_init();
 
-    delay_ms(500);
+    timebase_delay_ms(500);
 
     printf("\n---------------- LiteX BIOS --------------\n");
     printf("Tarefa 05 – Transmissão de dados via LoRa \n");
@@ -110,10 +342,48 @@ int main(void)
             ;
     }
 
+    prng_init(NODE_ID);
+    tdma_init(NODE_ID);
+    arq_init();
+    airtime_init();
+    adr_init();
+    bulk_init();
+    if (FEC_K)
+    {
+        fec_tx_init(FEC_K, FEC_M);
+    }
+
     while (1)
     {
-        transmit_sensor_data();
-        delay_ms(SENSOR_SEND_INTERVAL_MS);
+        // Escuta o beacon; sem ele o nó segue pelo relógio local por alguns
+        // superquadros e depois para de transmitir até ouvir outro
+        tdma_wait_beacon();
+        if (tdma_synced())
+        {
+            // Só o ARQ recebe ACKs: sem ele o nó fica na taxa máxima
+            adr_apply();
+            if (ARQ_ENABLE)
+            {
+                transmit_sensor_batch();
+            }
+            else if (FEC_K && fec_tx_parity_pending())
+            {
+                transmit_fec_parity();
+            }
+            else
+            {
+                transmit_sensor_data();
+            }
+        }
+
+        if (++superframes_since_report >= STATS_REPORT_SUPERFRAMES)
+        {
+            superframes_since_report = 0;
+            report_stats();
+        }
+
+        // Ocioso até o próximo beacon: hora de esvaziar o trace
+        trace_flush();
     }
 
     return 0;
@@ -0,0 +1,19 @@
+// prng.c
+#include "prng.h"
+
+#include "timebase.h"
+
+static uint32_t prng_state = 1; // Zero prenderia o xorshift em zero
+
+void prng_init(uint32_t seed) {
+    prng_state = (seed * 0x9E3779B1u) ^ timebase_ticks();
+    if (prng_state == 0) prng_state = 1;
+}
+
+// xorshift32
+uint32_t prng_next(void) {
+    prng_state ^= prng_state << 13;
+    prng_state ^= prng_state >> 17;
+    prng_state ^= prng_state << 5;
+    return prng_state;
+}
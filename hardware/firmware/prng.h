@@ -0,0 +1,25 @@
+// prng.h
+#ifndef PRNG_H_
+#define PRNG_H_
+
+#include <stdint.h>
+
+// ============================
+// === Funções Públicas ===
+// ============================
+// Um só gerador para todos os sorteios do nó (jitter do envio, backoff do
+// listen-before-talk): semeado uma vez, com a identidade do nó.
+
+/**
+ * @brief Semeia o gerador.
+ * @param seed Diferente em cada nó (NODE_ID), para não sortearem igual
+ * mesmo ligados no mesmo instante.
+ */
+void prng_init(uint32_t seed);
+
+/**
+ * @brief Próximo valor pseudoaleatório (xorshift32), nunca zero.
+ */
+uint32_t prng_next(void);
+
+#endif // PRNG_H_
@@ -0,0 +1,184 @@
+// tdma.c
+#include "tdma.h"
+
+#include <string.h>
+
+#include "airtime.h"
+#include "lora_RFM95.h"
+#include "lora_channels.h"
+#include "lora_frame.h"
+#include "timebase.h"
+#include "trace.h"
+
+// Ciclos locais por ms do gateway, em ponto fixo Q24.8
+#define TDMA_NOMINAL_Q8 ((uint32_t)TIMEBASE_TICKS_PER_MS << 8)
+
+static struct {
+    uint8_t node_id;
+    bool synced;
+    uint8_t missed;          // Beacons perdidos seguidos
+
+    // Superquadro atual (do último beacon ou previsto pelo relógio local)
+    uint64_t start;          // Início, em ciclos locais
+    uint16_t superframe;     // seq do beacon
+    uint16_t slot_ms;
+    uint8_t slot_count;
+    uint8_t hop_channels;    // Canais dos saltos anunciados no beacon
+    uint16_t implicit_slots; // Slots em cabeçalho implícito anunciados no beacon
+
+    // Último beacon recebido de fato, para medir o desvio do relógio
+    bool have_last;
+    uint64_t last_start;
+    uint32_t last_timestamp_ms;
+
+    uint32_t ticks_per_ms_q8;
+} tdma;
+
+static uint64_t tdma_ms_to_ticks(uint32_t ms) {
+    return ((uint64_t)ms * tdma.ticks_per_ms_q8) >> 8;
+}
+
+static uint32_t tdma_period_ms(void) {
+    return (uint32_t)tdma.slot_ms * tdma.slot_count;
+}
+
+// Compara o intervalo entre beacons nos dois relógios e corrige a escala
+// usada para converter a agenda do gateway em ciclos locais
+static void tdma_discipline(uint64_t start, uint32_t timestamp_ms) {
+    if (tdma.have_last) {
+        const uint32_t elapsed_ms = timestamp_ms - tdma.last_timestamp_ms;
+        if (elapsed_ms > 0 && elapsed_ms < 10 * 60 * 1000) {
+            const uint32_t measured = (uint32_t)(((start - tdma.last_start) << 8) / elapsed_ms);
+            const int32_t ppm = (int32_t)(((int64_t)measured - TDMA_NOMINAL_Q8) * 1000000 / TDMA_NOMINAL_Q8);
+
+            if (ppm < TDMA_MAX_DRIFT_PPM && ppm > -TDMA_MAX_DRIFT_PPM) {
+                // Média móvel de 1/4 contra o ruído da detecção do RxDone
+                tdma.ticks_per_ms_q8 += ((int32_t)measured - (int32_t)tdma.ticks_per_ms_q8) / 4;
+                TRACE_DEBUG(TDMA_DRIFT, 0, (int32_t)(((int64_t)tdma.ticks_per_ms_q8 - TDMA_NOMINAL_Q8) * 1000000 / TDMA_NOMINAL_Q8));
+            }
+        }
+    }
+    tdma.have_last = true;
+    tdma.last_start = start;
+    tdma.last_timestamp_ms = timestamp_ms;
+}
+
+static void tdma_on_beacon(const frame_beacon_t *beacon, uint64_t rx_done) {
+    // O RxDone marca o fim do beacon; o superquadro começou um tempo no ar antes
+    const uint64_t start = rx_done - (uint64_t)lora_time_on_air_us(FRAME_BEACON_LEN) * TIMEBASE_TICKS_PER_US;
+
+    tdma_discipline(start, beacon->timestamp_ms);
+
+    tdma.start = start;
+    tdma.superframe = beacon->header.seq;
+    tdma.slot_ms = beacon->slot_ms;
+    tdma.slot_count = beacon->slot_count;
+    tdma.hop_channels = beacon->hop_channels;
+    tdma.implicit_slots = beacon->implicit_slots;
+    tdma.synced = true;
+    tdma.missed = 0;
+
+    TRACE_INFO(TDMA_BEACON, frame_tdma_slot(tdma.node_id, tdma.slot_count), tdma.superframe);
+}
+
+void tdma_init(uint8_t node_id) {
+    memset(&tdma, 0, sizeof(tdma));
+    tdma.node_id = node_id;
+    tdma.ticks_per_ms_q8 = TDMA_NOMINAL_Q8;
+}
+
+bool tdma_synced(void) {
+    return tdma.synced;
+}
+
+uint64_t tdma_slot_end(void) {
+    const uint8_t slot = frame_tdma_slot(tdma.node_id, tdma.slot_count);
+    return tdma.start + tdma_ms_to_ticks((uint32_t)(slot + 1) * tdma.slot_ms);
+}
+
+bool tdma_slot_implicit(void) {
+    const uint8_t slot = frame_tdma_slot(tdma.node_id, tdma.slot_count);
+    return tdma.synced && slot < 16 && (tdma.implicit_slots & (1u << slot)) != 0;
+}
+
+bool tdma_wait_beacon(void) {
+    uint8_t buf[sizeof(frame_beacon_t)];
+    frame_beacon_t beacon;
+
+    // Sincronizado: o próximo beacon termina dentro do slot 0 do próximo superquadro
+    const uint64_t deadline = tdma.synced
+        ? tdma.start + tdma_ms_to_ticks(tdma_period_ms() + tdma.slot_ms)
+        : timebase_ticks64() + tdma_ms_to_ticks(TDMA_SEARCH_MS);
+
+    // O beacon não salta nem muda de taxa: sempre no mesmo canal, em SF
+    // máximo e cabeçalho explícito
+    lora_set_channel(LORA_BEACON_CHANNEL);
+    lora_set_sf(LORA_SF_MAX);
+    lora_set_implicit_header(0);
+    lora_start_rx_continuous();
+    while (timebase_ticks64() < deadline) {
+        // Quadros de outros nós também chegam aqui e são ignorados
+        if (lora_receive_bytes(buf, sizeof(buf)) != FRAME_BEACON_LEN) continue;
+        const uint64_t rx_done = timebase_ticks64();
+
+        memcpy(&beacon, buf, FRAME_BEACON_LEN);
+        if (FRAME_TYPE(&beacon.header) != FRAME_TYPE_BEACON) continue;
+        if (beacon.header.node_id != FRAME_NODE_GATEWAY) continue;
+        if (beacon.slot_count < 2 || beacon.slot_ms == 0) continue;
+        if (beacon.hop_channels > LORA_CHANNEL_COUNT) continue;
+
+        lora_set_mode(0x01); // Standby até o slot
+        tdma_on_beacon(&beacon, rx_done);
+        return true;
+    }
+    lora_set_mode(0x01); // Standby
+
+    if (tdma.synced) {
+        tdma.missed++;
+        TRACE_WARN(TDMA_MISSED, 0, tdma.missed);
+        if (tdma.missed > TDMA_MAX_MISSED) {
+            tdma.synced = false;
+            TRACE_ERROR(TDMA_SYNC_LOST, 0, 0);
+        } else {
+            // Segue a agenda prevista pelo relógio disciplinado
+            tdma.start += tdma_ms_to_ticks(tdma_period_ms());
+            tdma.superframe++;
+        }
+    }
+    return false;
+}
+
+bool tdma_wait_slot(uint32_t busy_ms) {
+    if (!tdma.synced) return false;
+
+    // Com LBT a troca começa por um CAD
+    if (LORA_LBT_ENABLE) busy_ms += lora_cad_time_us() / 1000 + 1;
+
+    const uint8_t slot = frame_tdma_slot(tdma.node_id, tdma.slot_count);
+    const uint32_t margin_ms = tdma.slot_ms > busy_ms ? (tdma.slot_ms - busy_ms) / 2 : 0;
+    // Início sorteado em torno do centro, mantendo metade da folga de cada
+    // lado: nós que dividem um slot não ficam presos na mesma colisão
+    const uint32_t offset_ms = margin_ms / 2 + airtime_jitter_ms(margin_ms);
+    const uint64_t tx_at = tdma.start + tdma_ms_to_ticks((uint32_t)slot * tdma.slot_ms + offset_ms);
+
+    if (timebase_ticks64() > tx_at) {
+        TRACE_WARN(TDMA_SLOT_LATE, slot, 0);
+        return false;
+    }
+
+    // Backoffs do LBT só até onde a troca ainda termina dentro do slot;
+    // depois disso o envio fica para o próximo superquadro
+    const uint64_t slot_end = tdma_slot_end();
+    const uint64_t busy_ticks = tdma_ms_to_ticks(busy_ms);
+    lora_set_lbt_deadline(slot_end > tx_at + busy_ticks ? slot_end - busy_ticks : tx_at);
+
+    // Canal do slot neste superquadro; o ACK volta pelo mesmo canal
+    const uint8_t channel = lora_hop_channel(tdma.superframe, slot, tdma.hop_channels);
+    lora_set_channel(channel);
+    TRACE_DEBUG(TDMA_HOP, channel, tdma.superframe);
+
+    while (timebase_ticks64() < tx_at) {
+        /* Aguarda o slot */
+    }
+    return true;
+}
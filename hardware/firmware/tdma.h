@@ -0,0 +1,70 @@
+// tdma.h
+#ifndef TDMA_H_
+#define TDMA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ============================
+// === Configuração ===
+// ============================
+// Beacons perdidos seguidos em que o nó ainda transmite pelo relógio local
+#define TDMA_MAX_MISSED 3
+
+// Escuta máxima por um beacon sem sincronismo, antes de voltar ao laço
+// principal (que aproveita para esvaziar o trace)
+#define TDMA_SEARCH_MS 30000
+
+// Desvio aceito entre o relógio local e o do gateway; medições acima
+// disso (beacon atrasado, superquadros pulados) são descartadas
+#define TDMA_MAX_DRIFT_PPM 1000
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Inicializa o escalonador sem sincronismo.
+ * @param node_id Identificação deste nó, define o slot (frame_tdma_slot()).
+ */
+void tdma_init(uint8_t node_id);
+
+/**
+ * @brief Escuta o próximo beacon do gateway.
+ * Sincronizado, espera até o fim do slot de beacon previsto; se ele não
+ * chegar, segue pelo relógio local por até TDMA_MAX_MISSED superquadros.
+ * Sem sincronismo, escuta por até TDMA_SEARCH_MS.
+ * @return true se um beacon chegou.
+ */
+bool tdma_wait_beacon(void);
+
+/**
+ * @brief Espera o slot deste nó no superquadro atual.
+ * A ocupação do canal fica perto do centro do slot, com folga dos dois
+ * lados e um atraso sorteado (airtime_jitter_ms()).
+ * @param busy_ms Duração da troca no slot: tempo no ar do quadro, mais a
+ * janela do ACK quando houver. O CAD do LBT é somado aqui, e os backoffs
+ * ficam limitados ao resto do slot (lora_set_lbt_deadline()).
+ * @return true na hora de transmitir; false sem sincronismo ou se o slot
+ * já passou.
+ */
+bool tdma_wait_slot(uint32_t busy_ms);
+
+/**
+ * @brief Indica se o nó segue a agenda do gateway.
+ */
+bool tdma_synced(void);
+
+/**
+ * @brief Fim do slot deste nó no superquadro atual, em ciclos
+ * (timebase_ticks64()).
+ */
+uint64_t tdma_slot_end(void);
+
+/**
+ * @brief Indica se o gateway ouve o slot deste nó em cabeçalho implícito
+ * (frame_beacon_t.implicit_slots) no superquadro atual.
+ */
+bool tdma_slot_implicit(void);
+
+#endif // TDMA_H_
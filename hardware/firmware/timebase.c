@@ -0,0 +1,55 @@
+// timebase.c
+#include "timebase.h"
+
+#include <generated/csr.h>
+#include <generated/soc.h>
+
+// Voltas completas do contador, para timebase_ticks64()
+static uint32_t timebase_last = 0;
+static uint32_t timebase_wraps = 0;
+
+void timebase_init(void) {
+#ifdef CSR_TIMER0_BASE
+    // Contador decrescente de 32 bits que recarrega sozinho ao chegar em 0
+    timer0_en_write(0);
+    timer0_load_write(0xFFFFFFFF);
+    timer0_reload_write(0xFFFFFFFF);
+    timer0_en_write(1);
+#endif
+}
+
+uint32_t timebase_ticks(void) {
+#ifdef CSR_TIMER0_BASE
+    timer0_update_value_write(1);
+    const uint32_t now = 0xFFFFFFFF - timer0_value_read();
+    if (now < timebase_last) timebase_wraps++;
+    timebase_last = now;
+    return now;
+#else
+    return 0;
+#endif
+}
+
+uint64_t timebase_ticks64(void) {
+    const uint32_t now = timebase_ticks();
+    return ((uint64_t)timebase_wraps << 32) | now;
+}
+
+void timebase_delay_us(uint32_t us) {
+#ifdef CSR_TIMER0_BASE
+    const uint32_t start = timebase_ticks();
+    const uint32_t ticks = us * TIMEBASE_TICKS_PER_US;
+    while (timebase_ticks() - start < ticks) {
+        /* Aguarda */
+    }
+#else
+    for (volatile uint32_t i = 0; i < us * 2; i++);
+#endif
+}
+
+void timebase_delay_ms(uint32_t ms) {
+    // Em passos de 1 ms para não estourar us * TIMEBASE_TICKS_PER_US
+    for (uint32_t i = 0; i < ms; ++i) {
+        timebase_delay_us(1000);
+    }
+}
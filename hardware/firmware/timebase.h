@@ -0,0 +1,46 @@
+// timebase.h
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <stdint.h>
+#include <generated/soc.h>
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Coloca o timer0 em contagem livre (recarga automática).
+ * Substitui o busy_wait_us() da LiteX, que reprograma o timer0 a cada
+ * chamada e impede usá-lo como relógio.
+ */
+void timebase_init(void);
+
+/**
+ * @brief Ciclos de clock do sistema desde timebase_init().
+ * Volta a zero a cada 2^32 ciclos (~71 s a 60 MHz); use diferenças.
+ */
+uint32_t timebase_ticks(void);
+
+/**
+ * @brief Ciclos desde timebase_init() em 64 bits, sem voltar a zero.
+ * As voltas do contador são contadas a cada leitura do timebase: basta
+ * que algo o leia pelo menos uma vez a cada 2^32 ciclos.
+ */
+uint64_t timebase_ticks64(void);
+
+/**
+ * @brief Espera ocupada em microssegundos, sem parar o relógio.
+ */
+void timebase_delay_us(uint32_t us);
+
+/**
+ * @brief Espera ocupada em milissegundos, sem parar o relógio.
+ */
+void timebase_delay_ms(uint32_t ms);
+
+// Conversões de tempo para ciclos do timebase
+#define TIMEBASE_TICKS_PER_US (CONFIG_CLOCK_FREQUENCY / 1000000)
+#define TIMEBASE_TICKS_PER_MS (CONFIG_CLOCK_FREQUENCY / 1000)
+
+#endif // TIMEBASE_H_
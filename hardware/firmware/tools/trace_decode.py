@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+"""
+Decodifica o trace binário do firmware (trace.c) de volta para texto.
+
+Lê a saída da UART (arquivo, stdin ou porta serial), repassa o texto comum
+do console e troca cada registro de trace pela mensagem do evento, tirada
+dos comentários da lista de eventos em trace.h.
+
+Uso:
+    trace_decode.py [captura.bin]             (stdin sem arquivo)
+    trace_decode.py --port /dev/ttyUSB1       (requer pyserial)
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+SYNC = b"\xfeT"
+RECORD = struct.Struct("<IHhi")  # timestamp, id, a, b
+FRAME_LEN = len(SYNC) + RECORD.size + 1
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+
+def load_events(header):
+    with open(header, encoding="utf-8") as f:
+        body = f.read().split("typedef enum", 1)[1].split("} trace_id_t", 1)[0]
+    events = []
+    for name, text in re.findall(r"TRACE_(\w+)(?:\s*=\s*\d+)?\s*,\s*//\s*\"(.*)\"", body):
+        events.append((name, text))
+    return events
+
+
+def render(text, a, b):
+    return (text.replace("{a/100}", "%.2f" % (a / 100.0))
+                .replace("{b/100}", "%.2f" % (b / 100.0))
+                .replace("{a}", str(a))
+                .replace("{b}", str(b)))
+
+
+class Decoder:
+    def __init__(self, events, clock_hz, out):
+        self.events = events
+        self.clock_hz = clock_hz
+        self.out = out
+        self.buf = b""
+        self.last = None
+        self.wraps = 0
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            i = self.buf.find(SYNC)
+            if i < 0:
+                # Guarda um possível início de sync partido entre leituras
+                keep = 1 if self.buf.endswith(SYNC[:1]) else 0
+                self.text(self.buf[:len(self.buf) - keep])
+                self.buf = self.buf[len(self.buf) - keep:]
+                return
+            self.text(self.buf[:i])
+            self.buf = self.buf[i:]
+            if len(self.buf) < FRAME_LEN:
+                return
+            payload = self.buf[len(SYNC):FRAME_LEN - 1]
+            check = 0
+            for byte in payload:
+                check ^= byte
+            if check != self.buf[FRAME_LEN - 1]:
+                self.text(self.buf[:1])  # Não era um registro
+                self.buf = self.buf[1:]
+                continue
+            self.record(*RECORD.unpack(payload))
+            self.buf = self.buf[FRAME_LEN:]
+
+    def text(self, data):
+        if data:
+            self.out.write(data.decode("utf-8", "replace"))
+            self.out.flush()
+
+    def record(self, timestamp, event, a, b):
+        # O timebase volta a zero a cada 2^32 ciclos
+        if self.last is not None and timestamp < self.last:
+            self.wraps += 1
+        self.last = timestamp
+        seconds = (self.wraps * 2**32 + timestamp) / self.clock_hz
+
+        if event < len(self.events):
+            name, text = self.events[event]
+            message = render(text, a, b)
+        else:
+            name, message = "?", "evento %d desconhecido (a=%d, b=%d)" % (event, a, b)
+        self.out.write("[%12.6f] %-16s %s\n" % (seconds, name, message))
+        self.out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("capture", nargs="?", help="arquivo capturado da UART")
+    parser.add_argument("--port", help="porta serial para ler ao vivo")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--clock", type=float, default=60e6,
+                        help="clock do sistema em Hz (CONFIG_CLOCK_FREQUENCY)")
+    parser.add_argument("--header", default=os.path.join(HERE, "..", "trace.h"))
+    args = parser.parse_args()
+
+    decoder = Decoder(load_events(args.header), args.clock, sys.stdout)
+
+    if args.port:
+        import serial  # pyserial
+        with serial.Serial(args.port, args.baud) as port:
+            while True:
+                decoder.feed(port.read(port.in_waiting or 1))
+    else:
+        src = open(args.capture, "rb") if args.capture else sys.stdin.buffer
+        with src:
+            while True:
+                data = src.read(4096)
+                if not data:
+                    break
+                decoder.feed(data)
+        decoder.text(decoder.buf)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,48 @@
+// trace.c
+#include "trace.h"
+
+#include <uart.h>
+
+// Início de cada registro na UART: 0xFE não aparece em texto ASCII/UTF-8,
+// então o decodificador separa os registros do restante do console
+#define TRACE_SYNC_0 0xFE
+#define TRACE_SYNC_1 'T'
+
+trace_record_t trace_ring[TRACE_RING_SIZE];
+uint32_t trace_head = 0;
+uint32_t trace_tail = 0;
+uint32_t trace_dropped = 0;
+
+// Quadro: sync (2) + registro little-endian (12) + XOR dos 12 bytes (1)
+static void trace_send(const trace_record_t *r) {
+    uint8_t bytes[12] = {
+        (uint8_t)(r->timestamp), (uint8_t)(r->timestamp >> 8),
+        (uint8_t)(r->timestamp >> 16), (uint8_t)(r->timestamp >> 24),
+        (uint8_t)(r->id), (uint8_t)(r->id >> 8),
+        (uint8_t)(r->a), (uint8_t)((uint16_t)r->a >> 8),
+        (uint8_t)(r->b), (uint8_t)(r->b >> 8),
+        (uint8_t)(r->b >> 16), (uint8_t)((uint32_t)r->b >> 24),
+    };
+    uint8_t check = 0;
+
+    uart_write(TRACE_SYNC_0);
+    uart_write(TRACE_SYNC_1);
+    for (int i = 0; i < 12; i++) {
+        uart_write(bytes[i]);
+        check ^= bytes[i];
+    }
+    uart_write(check);
+}
+
+void trace_flush(void) {
+    while (trace_tail != trace_head) {
+        trace_send(&trace_ring[trace_tail % TRACE_RING_SIZE]);
+        trace_tail++;
+    }
+
+    if (trace_dropped) {
+        trace_record_t lost = {timebase_ticks(), TRACE_DROPPED, 0, (int32_t)trace_dropped};
+        trace_send(&lost);
+        trace_dropped = 0;
+    }
+}
@@ -0,0 +1,141 @@
+// trace.h
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+#include "timebase.h"
+
+// ============================
+// === Níveis de Log ===
+// ============================
+// Escolhidos em tempo de compilação (make TRACE_LEVEL=1): eventos acima do
+// nível somem do binário, sem custo nenhum no caminho crítico.
+#define TRACE_LEVEL_NONE  0
+#define TRACE_LEVEL_ERROR 1
+#define TRACE_LEVEL_WARN  2
+#define TRACE_LEVEL_INFO  3
+#define TRACE_LEVEL_DEBUG 4
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_WARN
+#endif
+
+// ============================
+// === Eventos ===
+// ============================
+// Só acrescente no final: o decodificador (tools/trace_decode.py) lê esta
+// lista e usa o comentário de cada evento como texto, com {a} e {b} no
+// lugar dos argumentos ({a/100} e {b/100} para valores x100).
+typedef enum {
+    TRACE_DROPPED = 0,        // "trace: {b} eventos perdidos (anel cheio)"
+    TRACE_SENSOR_READ,        // "AHT10: {a/100} C, {b/100} %"
+    TRACE_SENSOR_FAIL,        // "AHT10: falha na leitura, envio cancelado"
+    TRACE_SENSOR_BUSY,        // "AHT10: sensor ainda ocupado"
+    TRACE_LORA_TX_START,      // "LoRa: enviando {a} bytes"
+    TRACE_LORA_TX_DONE,       // "LoRa: pacote enviado em {b} ms"
+    TRACE_LORA_TX_TIMEOUT,    // "LoRa: timeout de TX, rádio em standby"
+    TRACE_LORA_BAD_LEN,       // "LoRa: tamanho de pacote inválido ({b} bytes)"
+    TRACE_LORA_TX_ERROR,      // "LoRa: erro durante o envio"
+    TRACE_LORA_RX_CRC_ERROR,  // "LoRa: pacote recebido com erro de CRC"
+    TRACE_TDMA_BEACON,        // "TDMA: beacon do superquadro {b}, slot {a}"
+    TRACE_TDMA_DRIFT,         // "TDMA: relógio local desvia {b} ppm do gateway"
+    TRACE_TDMA_MISSED,        // "TDMA: beacon perdido ({b} seguidos)"
+    TRACE_TDMA_SYNC_LOST,     // "TDMA: sem sincronismo, transmissão suspensa"
+    TRACE_TDMA_SLOT_LATE,     // "TDMA: slot {a} já passou, envio adiado"
+    TRACE_LORA_CAD_BUSY,      // "LBT: canal ocupado (tentativa {a}), espera de {b} ms"
+    TRACE_LORA_LBT_GAVE_UP,   // "LBT: canal ocupado em {a} CADs, envio cancelado ({b} no total)"
+    TRACE_ARQ_ACK,            // "ARQ: ACK até a amostra {b}, {a} ainda na fila"
+    TRACE_ARQ_ACK_TIMEOUT,    // "ARQ: sem ACK para o quadro {b}"
+    TRACE_ARQ_DROPPED,        // "ARQ: amostra {b} descartada após {a} envios"
+    TRACE_ARQ_INTERVAL,       // "ARQ: gateway pediu uma amostra a cada {a} superquadros"
+    TRACE_FEC_PARITY,         // "FEC: paridade {a} do grupo iniciado em {b}"
+    TRACE_TDMA_HOP,           // "TDMA: slot no canal {a}, superquadro {b}"
+    TRACE_AIRTIME_DEFERRED,   // "Tempo no ar: envio de {b} us adiado, saldo de {a} ms"
+    TRACE_AIRTIME_USAGE,      // "Tempo no ar: {a} por mil usado, {b} envios adiados"
+    TRACE_ADR_CHANGE,         // "ADR: SF{a}, {b} dBm"
+    TRACE_ADR_FALLBACK,       // "ADR: {b} ACKs perdidos, volta a SF{a} e potência máxima"
+    TRACE_BULK_NO_PROGRESS,   // "Despejo FSK: rodada {a} sem confirmação nova na janela {b}"
+    TRACE_BULK_DONE,          // "Despejo FSK: {b} leituras confirmadas, {a} ainda no log"
+    TRACE_LBT_CADS,           // "LBT: {b} CADs, {a} com o canal ocupado"
+    TRACE_LBT_RETRIES,        // "LBT: {b} esperas de backoff, {a} envios cancelados"
+    TRACE_ARQ_DELIVERY,       // "ARQ: {b} amostras confirmadas, {a} janelas sem ACK"
+    TRACE_ARQ_LOSS,           // "ARQ: {b} reenvios, {a} amostras descartadas"
+} trace_id_t;
+
+// Registro de 12 bytes guardado no anel
+typedef struct {
+    uint32_t timestamp; // timebase_ticks()
+    uint16_t id;        // trace_id_t
+    int16_t a;
+    int32_t b;
+} trace_record_t;
+
+// Registros no anel (potência de 2)
+#define TRACE_RING_SIZE 64
+
+extern trace_record_t trace_ring[TRACE_RING_SIZE];
+extern uint32_t trace_head;    // Próximo registro a escrever
+extern uint32_t trace_tail;    // Próximo registro a enviar
+extern uint32_t trace_dropped; // Eventos descartados com o anel cheio
+
+// ============================
+// === Funções Públicas ===
+// ============================
+
+/**
+ * @brief Grava um evento no anel: só memória, nenhum acesso à UART.
+ * Com o anel cheio o evento é descartado e contado.
+ */
+static inline void trace_event(trace_id_t id, int16_t a, int32_t b) {
+    if (trace_head - trace_tail >= TRACE_RING_SIZE) {
+        trace_dropped++;
+        return;
+    }
+    trace_record_t *r = &trace_ring[trace_head % TRACE_RING_SIZE];
+    r->timestamp = timebase_ticks();
+    r->id = (uint16_t)id;
+    r->a = a;
+    r->b = b;
+    trace_head++;
+}
+
+/**
+ * @brief Envia pela UART, em binário, os eventos pendentes.
+ * Chamar apenas quando o firmware está ocioso.
+ */
+void trace_flush(void);
+
+#if TRACE_LEVEL >= TRACE_LEVEL_ERROR
+#define TRACE_ERROR(id, a, b) trace_event(TRACE_##id, (a), (b))
+#else
+#define TRACE_ERROR(id, a, b) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_WARN
+#define TRACE_WARN(id, a, b) trace_event(TRACE_##id, (a), (b))
+#else
+#define TRACE_WARN(id, a, b) ((void)0)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(id, a, b) trace_event(TRACE_##id, (a), (b))
+#else
+#define TRACE_INFO(id, a, b) ((void)0)
+#endif
+
+// Relatórios periódicos de contadores para o operador: raros, saem já a
+// partir do nível de aviso (o padrão do make)
+#if TRACE_LEVEL >= TRACE_LEVEL_WARN
+#define TRACE_STATS(id, a, b) trace_event(TRACE_##id, (a), (b))
+#else
+#define TRACE_STATS(id, a, b) ((void)sizeof((a) + (b))) // Usa sem avaliar
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_DEBUG
+#define TRACE_DEBUG(id, a, b) trace_event(TRACE_##id, (a), (b))
+#else
+#define TRACE_DEBUG(id, a, b) ((void)0)
+#endif
+
+#endif // TRACE_H_
@@ -0,0 +1,123 @@
+// adr.c
+
+#include <stdio.h>
+#include "adr.h"
+#include "lora_RFM95.h"
+
+#define ADR_POWER_MAX_DBM 20
+#define ADR_POWER_MIN_DBM 2
+
+// SNR mínimo para demodular, por SF (SF7 .. SF12), em dB arredondado para cima
+static const int8_t adr_required_snr[LORA_SF_MAX - LORA_SF_MIN + 1] = {-7, -10, -12, -15, -17, -20};
+
+static uint8_t adr_node_sf(const node_stats_t *node) {
+    return node->adr_sf ? node->adr_sf : LORA_SF_MAX;
+}
+
+static int8_t adr_node_power(const node_stats_t *node) {
+    return node->adr_sf ? node->adr_power_dbm : ADR_POWER_MAX_DBM;
+}
+
+// O que o nó de fato usa: o SF em que os quadros chegam
+static uint8_t adr_used_sf(const node_stats_t *node) {
+    return node->adr_report ? FRAME_ADR_SF(node->adr_report) : LORA_SF_MAX;
+}
+
+static int8_t adr_used_power(const node_stats_t *node) {
+    return node->adr_report ? FRAME_ADR_POWER_DBM(node->adr_report) : ADR_POWER_MAX_DBM;
+}
+
+// Comando enviado e ainda não relatado pelo nó
+static bool adr_pending(const node_stats_t *node) {
+    return node->adr_sent != 0 && node->adr_sent != node->adr_report;
+}
+
+void adr_on_report(node_stats_t *node, uint8_t report) {
+    const uint8_t sf = FRAME_ADR_SF(report);
+    if (sf < LORA_SF_MIN || sf > LORA_SF_MAX || report == node->adr_report) return;
+
+    if (node->adr_report) {
+        printf("[ADR] Nó %u confirmou SF%u, %d dBm\n", node->node_id, sf, FRAME_ADR_POWER_DBM(report));
+    }
+    node->adr_report = report;
+    node_link_reset(node); // Próxima decisão só com quadros da taxa nova
+}
+
+bool adr_evaluate(node_stats_t *node) {
+    // A margem é medida na taxa em que os quadros chegaram; com um comando
+    // no ar o histórico ainda mistura as duas
+    if (node->snr_count < NODE_LINK_HISTORY || adr_pending(node)) return false;
+
+    uint8_t sf = adr_used_sf(node);
+    int8_t power = adr_used_power(node);
+    const int margin = node_link_snr_max(node) - adr_required_snr[sf - LORA_SF_MIN] - ADR_MARGIN_DB;
+    int steps = margin / ADR_STEP_DB; // Trunca em direção a zero: zona morta
+
+    // Sobra: primeiro SF menor (menos tempo no ar), depois menos potência
+    while (steps > 0 && sf > LORA_SF_MIN) {
+        sf--;
+        steps--;
+    }
+    while (steps > 0 && power - ADR_POWER_STEP_DBM >= ADR_POWER_MIN_DBM) {
+        power -= ADR_POWER_STEP_DBM;
+        steps--;
+    }
+    // Falta: primeiro potência, depois SF maior
+    while (steps < 0 && (power < ADR_POWER_MAX_DBM || sf < LORA_SF_MAX)) {
+        if (power < ADR_POWER_MAX_DBM) {
+            power = power + ADR_POWER_STEP_DBM > ADR_POWER_MAX_DBM ? ADR_POWER_MAX_DBM : power + ADR_POWER_STEP_DBM;
+        } else {
+            sf++;
+        }
+        steps++;
+    }
+
+    if (sf == adr_node_sf(node) && power == adr_node_power(node)) return false;
+
+    printf("[ADR] Nó %u: SF%u -> SF%u, %d -> %d dBm (margem %d dB)\n", node->node_id,
+           adr_used_sf(node), sf, adr_used_power(node), power, margin);
+    node->adr_sf = sf;
+    node->adr_power_dbm = power;
+    return true;
+}
+
+uint8_t adr_slot_sf(uint8_t slot, uint8_t slot_count) {
+    uint8_t sf = 0;
+
+    for (int i = 0; i < NODE_TABLE_SIZE; i++) {
+        const node_stats_t *n = node_table_at(i);
+        if (!n || n->node_id == FRAME_NODE_GATEWAY || n->node_id == FRAME_NODE_BROADCAST) continue;
+        if (frame_tdma_slot(n->node_id, slot_count) != slot) continue;
+        if (adr_node_sf(n) > sf) sf = adr_node_sf(n);
+    }
+    return sf ? sf : LORA_SF_MAX;
+}
+
+uint8_t adr_command(node_stats_t *node, uint8_t slot_count) {
+    const uint8_t sf = adr_slot_sf(frame_tdma_slot(node->node_id, slot_count), slot_count);
+    node->adr_sent = FRAME_ADR(sf, adr_node_power(node));
+    return node->adr_sent;
+}
+
+void adr_check_silent(uint64_t now_us, uint64_t confirm_us, uint64_t silence_us) {
+    for (int i = 0; i < NODE_TABLE_SIZE; i++) {
+        node_stats_t *n = node_table_at(i);
+        if (!n || now_us - n->last_rx_us < confirm_us) continue;
+
+        if (n->adr_sf != 0 && now_us - n->last_rx_us >= silence_us) {
+            printf("[ADR] Nó %u em silêncio: volta a SF%u\n", n->node_id, LORA_SF_MAX);
+            n->adr_sf = 0;
+            n->adr_power_dbm = 0;
+            n->adr_sent = 0;
+            n->adr_report = 0;
+            node_link_reset(n);
+        } else if (adr_pending(n)) {
+            // O ACK com o comando se perdeu e o nó segue na taxa antiga,
+            // que o gateway volta a ouvir; a próxima avaliação repete o pedido
+            printf("[ADR] Nó %u não confirmou o comando: fica em SF%u\n", n->node_id, adr_used_sf(n));
+            n->adr_sf = n->adr_report ? adr_used_sf(n) : 0;
+            n->adr_power_dbm = n->adr_report ? adr_used_power(n) : 0;
+            n->adr_sent = 0;
+        }
+    }
+}
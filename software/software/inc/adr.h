@@ -0,0 +1,70 @@
+// adr.h
+//
+// Taxa adaptativa: a partir do SNR dos quadros de cada nó, o gateway
+// escolhe o menor spreading factor (e depois a menor potência) que ainda
+// deixa ADR_MARGIN_DB de folga, e manda o comando nos ACKs. Como o rádio
+// ouve um SF por vez, o gateway troca de SF a cada slot; nós que dividem
+// um slot ficam no maior SF entre eles. A margem conta a partir da taxa que
+// o nó relata nos lotes, e um comando só passa a valer com esse relato.
+// Sem ele (ACK perdido: o nó nem soube) o slot volta à taxa relatada.
+#ifndef ADR_H_
+#define ADR_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "node_table.h"
+
+// Folga exigida acima do SNR mínimo do SF, contra desvanecimento
+#define ADR_MARGIN_DB 10
+
+// Cada passo de taxa ou potência gasta esta parte da margem. Margens entre
+// -ADR_STEP_DB e +ADR_STEP_DB não mudam nada (histerese).
+#define ADR_STEP_DB 3
+
+// Passo de potência dos nós (FRAME_ADR())
+#define ADR_POWER_STEP_DBM 2
+
+// Superquadros sem ouvir um nó com taxa reduzida antes de voltar ao SF
+// máximo, somados ao intervalo entre amostras
+#define ADR_FALLBACK_SUPERFRAMES 4
+
+// Superquadros, somados ao intervalo entre amostras, à espera do relato
+// de um comando antes de ouvir o nó de novo na taxa antiga
+#define ADR_CONFIRM_SUPERFRAMES 1
+
+/**
+ * @brief Registra a taxa e a potência que o nó relata num lote
+ * (frame_batch_t.adr). Chamar antes de node_link_update() com o SNR do
+ * mesmo quadro: uma mudança recomeça o histórico.
+ */
+void adr_on_report(node_stats_t *node, uint8_t report);
+
+/**
+ * @brief Reavalia taxa e potência de um nó quando o histórico de SNR
+ * está completo e não há comando à espera de relato.
+ * @return true se o comando mudou.
+ */
+bool adr_evaluate(node_stats_t *node);
+
+/**
+ * @brief Comando de taxa e potência para o ACK de um nó (FRAME_ADR()),
+ * guardado até o nó relatá-lo.
+ * @param slot_count Slots no superquadro, para achar os vizinhos de slot.
+ */
+uint8_t adr_command(node_stats_t *node, uint8_t slot_count);
+
+/**
+ * @brief SF em que o gateway ouve um slot: o maior entre os nós dele.
+ */
+uint8_t adr_slot_sf(uint8_t slot, uint8_t slot_count);
+
+/**
+ * @brief Devolve ao SF máximo os nós que pararam de ser ouvidos, como o
+ * nó faz ao perder os ACKs, e desiste dos comandos não relatados. Chamar
+ * a cada superquadro.
+ * @param confirm_us Espera pelo relato de um comando.
+ * @param silence_us Silêncio tolerado.
+ */
+void adr_check_silent(uint64_t now_us, uint64_t confirm_us, uint64_t silence_us);
+
+#endif // ADR_H_
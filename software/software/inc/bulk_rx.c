@@ -0,0 +1,127 @@
+// bulk_rx.c
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "bulk_rx.h"
+#include "lora_RFM95.h"
+
+static struct {
+    bool active;
+    uint8_t node_id;
+    uint64_t start_us;
+    uint64_t end_us;
+    uint64_t last_rx_us;   // Último fragmento (ou o início)
+    bool have_window;
+    uint16_t window;       // Janela em curso
+    uint16_t bitmap;       // Bit i: fragmento window + i recebido
+    bool ack_due;          // Fragmentos desde o último ACK
+    uint32_t session_samples;
+    bulk_rx_stats_t stats;
+    bulk_rx_sample_t deliver;
+} bulk;
+
+void bulk_rx_init(bulk_rx_sample_t deliver) {
+    memset(&bulk, 0, sizeof(bulk));
+    bulk.deliver = deliver;
+}
+
+bool bulk_rx_active(void) {
+    return bulk.active;
+}
+
+bulk_rx_stats_t bulk_rx_get_stats(void) {
+    return bulk.stats;
+}
+
+void bulk_rx_start(uint8_t node_id, uint64_t end_us) {
+    bulk.active = true;
+    bulk.node_id = node_id;
+    bulk.start_us = time_us_64();
+    bulk.end_us = end_us;
+    bulk.last_rx_us = bulk.start_us;
+    bulk.have_window = false;
+    bulk.ack_due = false;
+    bulk.session_samples = 0;
+    bulk.stats.sessions++;
+
+    lora_fsk_begin();
+    lora_fsk_start_rx();
+}
+
+static void bulk_rx_ack(void) {
+    frame_bulk_ack_t ack = {
+        .header = {
+            .node_id = bulk.node_id,
+            .type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_BULK_ACK, 0),
+            .seq = bulk.window,
+        },
+        .bitmap = bulk.bitmap,
+    };
+
+    lora_fsk_send((const uint8_t *)&ack, sizeof(ack));
+    lora_fsk_start_rx();
+    bulk.ack_due = false;
+}
+
+// Uma janela nova só começa quando o nó terminou a anterior
+static void bulk_rx_fragment(const frame_bulk_t *frame, size_t count) {
+    if (!bulk.have_window || frame->window != bulk.window) {
+        bulk.have_window = true;
+        bulk.window = frame->window;
+        bulk.bitmap = 0;
+    }
+
+    const uint16_t index = (uint16_t)(frame->header.seq - frame->window);
+    if (index >= FRAME_BULK_WINDOW) return;
+
+    bulk.ack_due = true;
+    if (bulk.bitmap & (1u << index)) {
+        bulk.stats.duplicates++;
+        return;
+    }
+    bulk.bitmap |= (uint16_t)(1u << index);
+    bulk.stats.fragments++;
+
+    for (size_t i = 0; i < count; i++) {
+        bulk.deliver(bulk.node_id, &frame->samples[i]);
+    }
+    bulk.stats.samples += count;
+    bulk.session_samples += count;
+}
+
+static void bulk_rx_finish(uint64_t now_us) {
+    lora_fsk_end();
+    lora_start_rx_continuous();
+    bulk.active = false;
+
+    printf("[BULK] Nó %u: %lu leituras em %lu ms\n", bulk.node_id,
+           (unsigned long)bulk.session_samples, (unsigned long)((now_us - bulk.start_us) / 1000));
+}
+
+void bulk_rx_task(void) {
+    if (!bulk.active) return;
+
+    uint8_t buf[LORA_FSK_MAX_LEN];
+    int len = lora_fsk_receive(buf, sizeof(buf));
+    uint64_t now_us = time_us_64();
+
+    if (len > (int)FRAME_BULK_LEN(0) && len <= (int)sizeof(frame_bulk_t) &&
+        (len - FRAME_BULK_LEN(0)) % sizeof(frame_sample_t) == 0) {
+        frame_bulk_t frame;
+        memcpy(&frame, buf, (size_t)len);
+
+        if (FRAME_TYPE(&frame.header) == FRAME_TYPE_BULK && frame.header.node_id == bulk.node_id) {
+            bulk.last_rx_us = now_us;
+            bulk_rx_fragment(&frame, FRAME_BULK_COUNT((size_t)len));
+            if (FRAME_FLAGS(&frame.header) & FRAME_FLAG_ACK_REQ) bulk_rx_ack();
+        }
+    }
+
+    if (bulk.ack_due && now_us - bulk.last_rx_us >= BULK_RX_GAP_MS * 1000) {
+        bulk_rx_ack();
+    }
+    if (now_us >= bulk.end_us || now_us - bulk.last_rx_us >= BULK_RX_IDLE_MS * 1000) {
+        bulk_rx_finish(now_us);
+    }
+}
@@ -0,0 +1,65 @@
+// bulk_rx.h
+//
+// Recepção dos despejos do log em FSK (frame_bulk_t). O gateway concede o
+// despejo no ACK de um lote com FRAME_FLAG_BULK, troca o rádio para FSK
+// até o fim do slot do nó e confirma cada rodada de fragmentos com um
+// frame_bulk_ack_t.
+#ifndef BULK_RX_H_
+#define BULK_RX_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lora_frame.h"
+
+// SNR (LoRa) mínimo do nó para conceder: o FSK a 250 kbps ocupa quatro
+// vezes a banda e não tem o ganho de processamento do LoRa
+#define BULK_MIN_SNR_DB 8
+
+// Resto de slot mínimo para conceder: a troca de modem e uma janela cheia
+#define BULK_MIN_SLOT_MS 150
+
+// Sem fragmento novo por esse tempo, a rodada é confirmada mesmo sem o
+// último (o que pede o ACK pode ter se perdido)
+#define BULK_RX_GAP_MS 5
+
+// Sem fragmento por esse tempo o despejo termina antes do fim do slot
+#define BULK_RX_IDLE_MS 200
+
+// Recebe cada leitura nova do despejo
+typedef void (*bulk_rx_sample_t)(uint8_t node_id, const frame_sample_t *sample);
+
+typedef struct {
+    uint32_t sessions;   // Despejos recebidos
+    uint32_t fragments;  // Fragmentos novos
+    uint32_t duplicates; // Fragmentos repetidos (ACK perdido)
+    uint32_t samples;    // Leituras entregues
+} bulk_rx_stats_t;
+
+/**
+ * @brief Apaga o estado e os contadores.
+ * @param deliver Destino das leituras recebidas.
+ */
+void bulk_rx_init(bulk_rx_sample_t deliver);
+
+/**
+ * @brief Troca o rádio para FSK e espera os fragmentos do nó.
+ * @param node_id Nó que recebeu a concessão.
+ * @param end_us Fim do slot do nó (time_us_64()).
+ */
+void bulk_rx_start(uint8_t node_id, uint64_t end_us);
+
+/**
+ * @brief Indica se há um despejo em andamento: o rádio está em FSK e as
+ * funções LoRa não valem.
+ */
+bool bulk_rx_active(void);
+
+/**
+ * @brief Trata os fragmentos e confirma as rodadas. Ao fim do slot (ou
+ * com o nó em silêncio) volta ao LoRa, em recepção contínua.
+ */
+void bulk_rx_task(void);
+
+bulk_rx_stats_t bulk_rx_get_stats(void);
+
+#endif // BULK_RX_H_
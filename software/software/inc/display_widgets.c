@@ -0,0 +1,161 @@
+// display_widgets.c
+
+#include <string.h>
+#include "display_widgets.h"
+
+size_t format_fixed_x100(int16_t value, const char *suffix, char *buf) {
+    char digits[6];
+    size_t n = 0, len = 0;
+    int32_t v = value;
+    bool negative = v < 0;
+
+    if (negative) v = -v;
+    v = (v + 5) / 10; // Arredonda para décimos
+    if (v == 0) negative = false; // Evita "-0.0"
+
+    if (negative) buf[len++] = '-';
+
+    uint32_t inteiro = (uint32_t)v / 10;
+    do {
+        digits[n++] = (char)('0' + inteiro % 10);
+        inteiro /= 10;
+    } while (inteiro);
+    while (n) buf[len++] = digits[--n];
+
+    buf[len++] = '.';
+    buf[len++] = (char)('0' + v % 10);
+
+    while (*suffix) buf[len++] = *suffix++;
+    buf[len] = '\0';
+    return len;
+}
+
+void value_widget_init(value_widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font) {
+    w->x = x;
+    w->y = y;
+    w->font = font;
+    w->last[0] = '\0';
+    w->valid = false;
+}
+
+void value_widget_invalidate(value_widget_t *w) {
+    w->valid = false;
+}
+
+// Avanço horizontal de um caractere na fonte
+static uint8_t glyph_advance(const SSD1306_Font_t *font, char ch) {
+    return font->char_width ? font->char_width[ch - 32] : font->width;
+}
+
+bool value_widget_draw(value_widget_t *w, const char *text) {
+    const SSD1306_Font_t *font = w->font;
+    bool redraw_rest = !w->valid;
+    bool changed = false;
+    uint16_t x_new = w->x, x_old = w->x;
+    size_t i;
+
+    for (i = 0; i < VALUE_WIDGET_MAX_LEN && text[i]; i++) {
+        char old = w->valid ? w->last[i] : '\0';
+
+        // Em fonte proporcional a célula desenhada (Font.width) invade as
+        // vizinhas e as posições seguintes podem mudar: redesenha o resto
+        if (old != text[i] && (font->char_width != NULL || old == '\0')) {
+            redraw_rest = true;
+        }
+        if (redraw_rest || old != text[i]) {
+            ssd1306_SetCursor(x_new, w->y);
+            ssd1306_WriteChar(text[i], *font, White);
+            changed = true;
+        }
+
+        x_new += glyph_advance(font, text[i]);
+        if (old) x_old += glyph_advance(font, old);
+    }
+
+    // Apaga o que sobrou do texto anterior, se ele era mais longo
+    if (w->valid) {
+        for (size_t j = i; w->last[j]; j++) {
+            x_old += glyph_advance(font, w->last[j]);
+        }
+    }
+    if (x_old > x_new) {
+        ssd1306_FillRectangle(x_new, w->y, x_old - 1, w->y + font->height - 1, Black);
+        changed = true;
+    }
+
+    memcpy(w->last, text, i);
+    w->last[i] = '\0';
+    w->valid = true;
+    return changed;
+}
+
+void trend_chart_init(trend_chart_t *c, uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2,
+                      int16_t min, int16_t max) {
+    c->x1 = x1;
+    c->x2 = x2;
+    c->page1 = page1;
+    c->page2 = page2;
+    c->min = min;
+    c->max = (max > min) ? max : min + 1;
+    c->has_last = false;
+    ssd1306_FillRectangle(x1, page1 * 8, x2, page2 * 8 + 7, Black);
+}
+
+// Coluna nova, já rolada: apaga o que voltou pela rotação e liga à amostra anterior
+static void trend_chart_column(trend_chart_t *c, int16_t value) {
+    const int32_t top = c->page1 * 8;
+    const int32_t bottom = c->page2 * 8 + 7;
+
+    if (value < c->min) value = c->min;
+    if (value > c->max) value = c->max;
+    uint8_t y = (uint8_t)(bottom - ((int32_t)(value - c->min) * (bottom - top)) / (c->max - c->min));
+
+    ssd1306_DrawVLine(c->x2, top, bottom, Black);
+    uint8_t from = c->has_last ? c->last_y : y;
+    ssd1306_DrawVLine(c->x2, from, y, White);
+    c->last_y = y;
+    c->has_last = true;
+}
+
+// Envia a janela já rolada no framebuffer. Com DMA não espera o barramento
+// e devolve false se o envio anterior ainda não terminou
+static bool trend_chart_send(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2) {
+#if defined(SSD1306_USE_DMA) && defined(SSD1306_CONTENT_SCROLL)
+    // O controlador rola a própria RAM: só a coluna nova vai atrás do comando
+    return ssd1306_ScrollColumnAsync(SSD1306_SCROLL_LEFT, page1, page2, x1, x2) == SSD1306_OK;
+#elif defined(SSD1306_USE_DMA)
+    return ssd1306_UpdateWindowAsync(x1, x2, page1, page2) == SSD1306_OK;
+#elif defined(SSD1306_CONTENT_SCROLL)
+    ssd1306_ScrollColumn(SSD1306_SCROLL_LEFT, page1, page2, x1, x2);
+    ssd1306_UpdateWindow(x2, x2, page1, page2);
+    return true;
+#else
+    ssd1306_UpdateWindow(x1, x2, page1, page2);
+    return true;
+#endif
+}
+
+bool trend_chart_push(trend_chart_t *c, int16_t value, bool send) {
+    return trend_chart_push_group(&c, &value, 1, send);
+}
+
+bool trend_chart_push_group(trend_chart_t *const charts[], const int16_t values[], uint8_t count, bool send) {
+    if (count == 0) return true;
+
+    // Uma rolagem só, da primeira à última página do grupo
+    uint8_t page1 = charts[0]->page1, page2 = charts[0]->page2;
+    for (uint8_t i = 1; i < count; i++) {
+        if (charts[i]->page1 < page1) page1 = charts[i]->page1;
+        if (charts[i]->page2 > page2) page2 = charts[i]->page2;
+    }
+    const uint8_t x1 = charts[0]->x1, x2 = charts[0]->x2;
+
+    // Sem SSD1306_CONTENT_SCROLL (SSD1306 sem 0x2C/0x2D) a janela inteira é
+    // enviada; com ele o controlador rola junto e só a coluna nova sai
+    ssd1306_ScrollBuffer(SSD1306_SCROLL_LEFT, page1, page2, x1, x2);
+    for (uint8_t i = 0; i < count; i++) {
+        trend_chart_column(charts[i], values[i]);
+    }
+
+    return !send || trend_chart_send(x1, x2, page1, page2);
+}
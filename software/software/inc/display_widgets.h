@@ -0,0 +1,95 @@
+// display_widgets.h
+
+#ifndef DISPLAY_WIDGETS_H_
+#define DISPLAY_WIDGETS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "ssd1306.h"
+
+// Maior texto exibido por um widget de valor (sem o terminador)
+#define VALUE_WIDGET_MAX_LEN 10
+
+// Campo de texto que guarda o último texto desenhado para redesenhar
+// apenas as células de glifo que mudaram
+typedef struct {
+    uint8_t x;
+    uint8_t y;
+    const SSD1306_Font_t *font;
+    char last[VALUE_WIDGET_MAX_LEN + 1];
+    bool valid; // false: nada desenhado ainda (ou a tela foi apagada)
+} value_widget_t;
+
+/**
+ * @brief Formata um valor multiplicado por 100 com uma casa decimal, sem ponto flutuante.
+ * O valor é arredondado (ex: 2356 -> "23.6").
+ * @param value Valor * 100 (ex: temperatura do AHT10).
+ * @param suffix Texto acrescentado ao final (ex: "C", "%").
+ * @param buf Buffer de saída, com pelo menos 8 + strlen(suffix) bytes.
+ * @return Número de caracteres escritos (sem o terminador).
+ */
+size_t format_fixed_x100(int16_t value, const char *suffix, char *buf);
+
+/**
+ * @brief Inicializa um widget de valor na posição informada.
+ */
+void value_widget_init(value_widget_t *w, uint8_t x, uint8_t y, const SSD1306_Font_t *font);
+
+/**
+ * @brief Força o redesenho completo na próxima chamada (ex: após ssd1306_Fill).
+ */
+void value_widget_invalidate(value_widget_t *w);
+
+/**
+ * @brief Desenha o texto no framebuffer, rasterizando só os glifos alterados.
+ * @param w Widget.
+ * @param text Novo texto (truncado em VALUE_WIDGET_MAX_LEN).
+ * @return true se algum pixel foi alterado (framebuffer precisa ser enviado).
+ */
+bool value_widget_draw(value_widget_t *w, const char *text);
+
+// Gráfico de tendência (sparkline) rolado pelo hardware do SSD1306: a cada
+// amostra a área rola uma coluna e só a coluna nova é enviada pelo I2C
+typedef struct {
+    uint8_t x1, x2;       // Colunas da área do gráfico
+    uint8_t page1, page2; // Páginas de 8 px da área do gráfico
+    int16_t min, max;     // Faixa de valores exibida (mesma escala das amostras)
+    uint8_t last_y;       // Linha da amostra anterior, para ligar os pontos
+    bool has_last;
+} trend_chart_t;
+
+/**
+ * @brief Inicializa um gráfico de tendência e apaga sua área no framebuffer.
+ */
+void trend_chart_init(trend_chart_t *c, uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2,
+                      int16_t min, int16_t max);
+
+/**
+ * @brief Acrescenta uma amostra à direita do gráfico, rolando o resto para a esquerda.
+ * @param c Gráfico.
+ * @param value Amostra (fora da faixa é limitada às bordas).
+ * @param send true: envia o gráfico já rolado (com SSD1306_CONTENT_SCROLL,
+ *             rola o display pelo hardware e envia só a coluna nova), pelo
+ *             DMA quando há, sem esperar o barramento;
+ *             false: altera só o framebuffer (quadro inteiro será enviado depois).
+ * @return false se o envio pedido não começou (DMA ainda ocupado): o
+ *         framebuffer já mudou e o quadro inteiro precisa ser enviado.
+ */
+bool trend_chart_push(trend_chart_t *c, int16_t value, bool send);
+
+/**
+ * @brief Acrescenta uma amostra a cada gráfico de um grupo com as mesmas
+ * colunas, numa só rolagem e num só envio (com SSD1306_CONTENT_SCROLL o
+ * controlador pede dois quadros entre rolagens de uma coluna).
+ * @param charts Gráficos do grupo (mesmos x1 e x2).
+ * @param values Uma amostra por gráfico.
+ * @param count Número de gráficos.
+ * @param send Como em trend_chart_push().
+ * @return Como em trend_chart_push().
+ * @note As páginas entre os gráficos rolam junto: nessas colunas elas devem
+ *       ser iguais de coluna a coluna (vazias ou com linhas horizontais).
+ */
+bool trend_chart_push_group(trend_chart_t *const charts[], const int16_t values[], uint8_t count, bool send);
+
+#endif // DISPLAY_WIDGETS_H_
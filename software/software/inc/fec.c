@@ -0,0 +1,121 @@
+// fec.c
+#include "fec.h"
+
+#include <string.h>
+
+// Polinômio primitivo x^8 + x^4 + x^3 + x^2 + 1, gerador a = 2
+#define FEC_POLY 0x11D
+
+static uint8_t gf_exp[512]; // Duplicada: gf_exp[log a + log b] sem módulo
+static uint8_t gf_log[256];
+
+void fec_init(void) {
+    uint16_t x = 1;
+    for (int i = 0; i < 255; i++) {
+        gf_exp[i] = (uint8_t)x;
+        gf_exp[i + 255] = (uint8_t)x;
+        gf_log[x] = (uint8_t)i;
+        x <<= 1;
+        if (x & 0x100) x ^= FEC_POLY;
+    }
+    gf_exp[510] = gf_exp[0];
+    gf_exp[511] = gf_exp[1];
+    gf_log[0] = 0; // Indefinido; quem chama trata o zero
+}
+
+static uint8_t gf_mul(uint8_t a, uint8_t b) {
+    if (a == 0 || b == 0) return 0;
+    return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+static uint8_t gf_inv(uint8_t a) {
+    return gf_exp[255 - gf_log[a]];
+}
+
+// dst ^= c * src
+static void gf_mul_add(uint8_t *dst, const uint8_t *src, uint8_t c, size_t len) {
+    if (c == 0) return;
+    if (c == 1) {
+        for (size_t i = 0; i < len; i++) dst[i] ^= src[i];
+        return;
+    }
+    const uint8_t *exp_c = &gf_exp[gf_log[c]];
+    for (size_t i = 0; i < len; i++) {
+        if (src[i]) dst[i] ^= exp_c[gf_log[src[i]]];
+    }
+}
+
+// buf *= c
+static void gf_scale(uint8_t *buf, uint8_t c, size_t len) {
+    if (c == 1) return;
+    const uint8_t *exp_c = &gf_exp[gf_log[c]];
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i]) buf[i] = exp_c[gf_log[buf[i]]];
+    }
+}
+
+uint8_t fec_coef(uint8_t row, uint8_t index) {
+    return gf_exp[(row * index) % 255];
+}
+
+void fec_encode(uint8_t *parity, uint8_t row, uint8_t index, const uint8_t *symbol, size_t len) {
+    gf_mul_add(parity, symbol, fec_coef(row, index), len);
+}
+
+int fec_decode(uint8_t k, uint8_t *const *data, uint32_t have_data,
+               const uint8_t *const *parity, const uint8_t *rows, uint8_t parity_count, size_t len) {
+    uint8_t missing[FEC_MAX_K];
+    uint8_t e = 0;
+
+    for (uint8_t i = 0; i < k; i++) {
+        if (!(have_data & (1u << i))) missing[e++] = i;
+    }
+    if (e == 0) return 0;
+    if (e > parity_count || e > FEC_MAX_M) return -1;
+
+    // Síndromes: cada linha usada menos a parte dos dados recebidos. Ficam
+    // direto nos buffers dos ausentes, onde a eliminação termina a solução.
+    uint8_t a[FEC_MAX_M][FEC_MAX_M];
+    for (uint8_t r = 0; r < e; r++) {
+        uint8_t *s = data[missing[r]];
+        memcpy(s, parity[r], len);
+        for (uint8_t i = 0; i < k; i++) {
+            if (have_data & (1u << i)) gf_mul_add(s, data[i], fec_coef(rows[r], i), len);
+        }
+        for (uint8_t c = 0; c < e; c++) {
+            a[r][c] = fec_coef(rows[r], missing[c]);
+        }
+    }
+
+    // Gauss-Jordan em GF(256): A * x = s, com x nos mesmos buffers
+    for (uint8_t c = 0; c < e; c++) {
+        uint8_t p = c;
+        while (p < e && a[p][c] == 0) p++;
+        if (p == e) return -1; // Linhas de paridade dependentes
+        if (p != c) {
+            uint8_t tmp[FEC_MAX_M];
+            memcpy(tmp, a[p], sizeof(tmp));
+            memcpy(a[p], a[c], sizeof(tmp));
+            memcpy(a[c], tmp, sizeof(tmp));
+            // Troca os síndromes trocando o conteúdo dos buffers
+            uint8_t *sp = data[missing[p]], *sc = data[missing[c]];
+            for (size_t i = 0; i < len; i++) {
+                uint8_t t = sp[i];
+                sp[i] = sc[i];
+                sc[i] = t;
+            }
+        }
+
+        const uint8_t inv = gf_inv(a[c][c]);
+        for (uint8_t j = 0; j < e; j++) a[c][j] = gf_mul(a[c][j], inv);
+        gf_scale(data[missing[c]], inv, len);
+
+        for (uint8_t r = 0; r < e; r++) {
+            const uint8_t f = a[r][c];
+            if (r == c || f == 0) continue;
+            for (uint8_t j = 0; j < e; j++) a[r][j] ^= gf_mul(f, a[c][j]);
+            gf_mul_add(data[missing[r]], data[missing[c]], f, len);
+        }
+    }
+    return e;
+}
@@ -0,0 +1,191 @@
+// fec_rx.c
+
+#include <string.h>
+#include "fec.h"
+#include "fec_rx.h"
+
+_Static_assert(FEC_RX_HISTORY >= FRAME_FEC_MAX_K, "histórico menor que um grupo");
+
+// Símbolo como codificado pelo nó: [tamanho][quadro], zeros até o fim
+typedef struct {
+    bool valid;
+    uint16_t seq;
+    uint8_t symbol[FRAME_FEC_SYMBOL_MAX];
+} fec_rx_entry_t;
+
+typedef struct {
+    uint8_t node_id;
+    bool in_use;
+    uint32_t last_used;
+    fec_rx_entry_t history[FEC_RX_HISTORY]; // Posição seq % FEC_RX_HISTORY
+
+    // Grupo da última paridade recebida
+    bool have_group;
+    bool done;       // Resolvido ou dado como perdido: ignora as demais linhas
+    uint16_t base;
+    uint8_t k, m, symbol_len;
+    uint8_t rows_rx; // Bit r: linha r recebida
+    uint8_t parity[FRAME_FEC_MAX_M][FRAME_FEC_SYMBOL_MAX];
+} fec_rx_node_t;
+
+static fec_rx_node_t nodes[FEC_RX_NODES];
+static uint32_t use_counter;
+static fec_rx_deliver_t deliver_cb;
+static fec_rx_stats_t stats;
+
+void fec_rx_init(fec_rx_deliver_t deliver) {
+    fec_init();
+    memset(nodes, 0, sizeof(nodes));
+    memset(&stats, 0, sizeof(stats));
+    use_counter = 0;
+    deliver_cb = deliver;
+}
+
+// Estado do nó, reaproveitando o menos recente se não houver vaga
+static fec_rx_node_t *fec_rx_node(uint8_t node_id) {
+    fec_rx_node_t *oldest = &nodes[0];
+
+    for (int i = 0; i < FEC_RX_NODES; i++) {
+        if (nodes[i].in_use && nodes[i].node_id == node_id) {
+            nodes[i].last_used = ++use_counter;
+            return &nodes[i];
+        }
+        if (!nodes[i].in_use || (oldest->in_use && nodes[i].last_used < oldest->last_used)) {
+            oldest = &nodes[i];
+        }
+    }
+
+    memset(oldest, 0, sizeof(*oldest));
+    oldest->node_id = node_id;
+    oldest->in_use = true;
+    oldest->last_used = ++use_counter;
+    return oldest;
+}
+
+static fec_rx_entry_t *fec_rx_lookup(fec_rx_node_t *n, uint16_t seq) {
+    fec_rx_entry_t *e = &n->history[seq % FEC_RX_HISTORY];
+    return e->valid && e->seq == seq ? e : NULL;
+}
+
+static void fec_rx_store(fec_rx_node_t *n, uint16_t seq, const uint8_t *frame, size_t len) {
+    fec_rx_entry_t *e = &n->history[seq % FEC_RX_HISTORY];
+
+    memset(e->symbol, 0, sizeof(e->symbol));
+    e->symbol[0] = (uint8_t)len;
+    memcpy(&e->symbol[1], frame, len);
+    e->seq = seq;
+    e->valid = true;
+}
+
+void fec_rx_data(const uint8_t *frame, size_t len) {
+    frame_header_t header;
+
+    if (len < sizeof(header) || len + 1 > FRAME_FEC_SYMBOL_MAX) return;
+    memcpy(&header, frame, sizeof(header));
+
+    fec_rx_node_t *n = fec_rx_node(header.node_id);
+    if (FRAME_FLAGS(&header) & FRAME_FLAG_RESET) {
+        // Nó reiniciou: a sequência recomeça e o histórico não vale mais
+        memset(n->history, 0, sizeof(n->history));
+        n->have_group = false;
+    }
+    fec_rx_store(n, header.seq, frame, len);
+}
+
+// Resolve o grupo se as linhas recebidas bastam; senão espera a próxima
+static void fec_rx_try_decode(fec_rx_node_t *n) {
+    uint8_t work[FRAME_FEC_MAX_K][FRAME_FEC_SYMBOL_MAX];
+    uint8_t *data[FRAME_FEC_MAX_K];
+    const uint8_t *parity[FRAME_FEC_MAX_M];
+    uint8_t rows[FRAME_FEC_MAX_M];
+    uint8_t parity_count = 0;
+    uint32_t have = 0;
+    uint8_t missing = 0;
+
+    for (uint8_t i = 0; i < n->k; i++) {
+        const fec_rx_entry_t *e = fec_rx_lookup(n, (uint16_t)(n->base + i));
+        data[i] = work[i];
+        if (e) {
+            memcpy(work[i], e->symbol, n->symbol_len);
+            have |= 1u << i;
+        } else {
+            missing++;
+        }
+    }
+    for (uint8_t r = 0; r < n->m; r++) {
+        if (n->rows_rx & (1u << r)) {
+            parity[parity_count] = n->parity[r];
+            rows[parity_count++] = r;
+        }
+    }
+
+    if (missing == 0) {
+        n->done = true;
+        return;
+    }
+    if (missing > parity_count) {
+        // Última linha do grupo e ainda falta paridade
+        if (n->rows_rx & (1u << (n->m - 1))) {
+            stats.unrecoverable++;
+            n->done = true;
+        }
+        return;
+    }
+    n->done = true;
+    if (fec_decode(n->k, data, have, parity, rows, parity_count, n->symbol_len) < 0) {
+        stats.unrecoverable++;
+        return;
+    }
+
+    for (uint8_t i = 0; i < n->k; i++) {
+        if (have & (1u << i)) continue;
+
+        // Confere o quadro reconstruído antes de entregar
+        const uint16_t seq = (uint16_t)(n->base + i);
+        const uint8_t len = work[i][0];
+        frame_header_t header;
+        if (len < sizeof(header) || len >= n->symbol_len) continue;
+        memcpy(&header, &work[i][1], sizeof(header));
+        if (header.node_id != n->node_id || header.seq != seq) continue;
+
+        fec_rx_store(n, seq, &work[i][1], len);
+        stats.recovered++;
+        if (deliver_cb) deliver_cb(&work[i][1], len);
+    }
+}
+
+bool fec_rx_parity(const uint8_t *frame, size_t len) {
+    frame_parity_t p;
+
+    if (len < FRAME_PARITY_LEN(0) || len > sizeof(p)) return false;
+    memcpy(&p, frame, len);
+    if (p.k == 0 || p.k > FRAME_FEC_MAX_K || p.m == 0 || p.m > FRAME_FEC_MAX_M || p.row >= p.m ||
+        p.symbol_len > FRAME_FEC_SYMBOL_MAX || len != FRAME_PARITY_LEN(p.symbol_len)) {
+        return false;
+    }
+
+    fec_rx_node_t *n = fec_rx_node(p.header.node_id);
+    if (!n->have_group || n->base != p.header.seq || n->k != p.k || n->m != p.m ||
+        n->symbol_len != p.symbol_len) {
+        // Novo grupo: as linhas do anterior que faltaram não chegam mais
+        n->have_group = true;
+        n->done = false;
+        n->base = p.header.seq;
+        n->k = p.k;
+        n->m = p.m;
+        n->symbol_len = p.symbol_len;
+        n->rows_rx = 0;
+    } else if (n->done || (n->rows_rx & (1u << p.row))) {
+        return true; // Grupo já resolvido, ou linha repetida
+    }
+
+    memcpy(n->parity[p.row], p.parity, p.symbol_len);
+    n->rows_rx |= 1u << p.row;
+    stats.parity_rx++;
+    fec_rx_try_decode(n);
+    return true;
+}
+
+fec_rx_stats_t fec_rx_get_stats(void) {
+    return stats;
+}
@@ -0,0 +1,49 @@
+// fec_rx.h
+//
+// Recuperação de quadros perdidos com a paridade enviada pelos nós
+// (frame_parity_t). Guarda os últimos quadros com FRAME_FLAG_FEC de cada nó
+// e, quando chega uma linha de paridade, reconstrói os que faltam no grupo.
+#ifndef FEC_RX_H_
+#define FEC_RX_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lora_frame.h"
+
+// Nós acompanhados ao mesmo tempo; o menos recente dá lugar a um novo
+#define FEC_RX_NODES 8
+
+// Quadros guardados por nó; deve cobrir o maior grupo (FRAME_FEC_MAX_K)
+#define FEC_RX_HISTORY 16
+
+// Recebe cada quadro reconstruído, igual ao enviado pelo nó
+typedef void (*fec_rx_deliver_t)(const uint8_t *frame, size_t len);
+
+typedef struct {
+    uint32_t parity_rx;     // Quadros de paridade aceitos
+    uint32_t recovered;     // Quadros reconstruídos
+    uint32_t unrecoverable; // Grupos com mais perdas do que paridade recebida
+} fec_rx_stats_t;
+
+/**
+ * @brief Monta as tabelas do código e apaga o histórico.
+ * @param deliver Destino dos quadros reconstruídos.
+ */
+void fec_rx_init(fec_rx_deliver_t deliver);
+
+/**
+ * @brief Guarda um quadro de dados com FRAME_FLAG_FEC.
+ */
+void fec_rx_data(const uint8_t *frame, size_t len);
+
+/**
+ * @brief Trata um quadro de paridade: reconstrói o que for possível do
+ * grupo e entrega pelo callback de fec_rx_init().
+ * @return false se o quadro é inválido.
+ */
+bool fec_rx_parity(const uint8_t *frame, size_t len);
+
+fec_rx_stats_t fec_rx_get_stats(void);
+
+#endif // FEC_RX_H_
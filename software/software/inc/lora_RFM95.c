@@ -5,6 +5,7 @@
 #include "pico/stdlib.h"
 #include "hardware/irq.h"
 #include "lora_RFM95.h"
+#include "lora_channels.h"
 
 // ============================
 // DEFINIÇÕES E REGISTRADORES INTERNOS
@@ -36,6 +37,30 @@
 #define REG_DIO_MAPPING_1        0x40 // Mapeia as funções dos pinos de interrupção digital DIO0 a DIO3 (ex: TxDone, RxDone). [cite: 2182, 871]
 #define REG_VERSION              0x42 // Contém a versão do chip de silício. Útil para verificar a comunicação e identificar o hardware. [cite: 2182, 2313]
 #define REG_PA_DAC               0x4D // Configurações do DAC do amplificador de potência, incluindo a ativação do modo de alta potência de +20dBm. [cite: 2187, 1930]
+// Registradores do modo FSK (LongRangeMode = 0): de 0x0D a 0x3F o mapa é
+// outro, com os mesmos endereços dos registradores LoRa
+#define REG_BITRATE_MSB          0x02
+#define REG_BITRATE_LSB          0x03
+#define REG_FDEV_MSB             0x04
+#define REG_FDEV_LSB             0x05
+#define REG_PA_RAMP              0x0A
+#define REG_RX_CONFIG            0x0D
+#define REG_RX_BW                0x12
+#define REG_AFC_BW               0x13
+#define REG_PREAMBLE_DETECT      0x1F
+#define REG_FSK_PREAMBLE_MSB     0x25
+#define REG_FSK_PREAMBLE_LSB     0x26
+#define REG_SYNC_CONFIG          0x27
+#define REG_SYNC_VALUE_1         0x28
+#define REG_PACKET_CONFIG_1      0x30
+#define REG_PACKET_CONFIG_2      0x31
+#define REG_FSK_PAYLOAD_LENGTH   0x32
+#define REG_FIFO_THRESH          0x35
+#define REG_IRQ_FLAGS_2          0x3F
+#define IRQ2_FIFO_OVERRUN        0x10
+#define IRQ2_PACKET_SENT         0x08
+#define IRQ2_PAYLOAD_READY       0x04
+
 // MODOS
 #define MODE_SLEEP               0x00
 #define MODE_STDBY               0x01
@@ -47,8 +72,40 @@
 #define IRQ_PAYLOAD_CRC_ERROR_MASK 0x20
 #define IRQ_RX_DONE_MASK         0x40
 
+#define REG_PKT_SNR_VALUE        0x19 // SNR do pacote mais recente, em quartos de dB com sinal.
 #define REG_PKT_RSSI_VALUE       0x1A // Contém o valor do RSSI do pacote mais recente.
 
+// Parâmetros do modem: geram os registradores ModemConfig e o tempo no ar.
+// Devem ser iguais aos do transmissor (hardware/firmware/lora_RFM95.c).
+#define LORA_SF          LORA_SF_MAX // Spreading factor do boot e do beacon
+#define LORA_BW_CODE     7      // ModemConfig1[7:4]: 7 = 125 kHz
+#define LORA_BW_HZ       125000
+#define LORA_CR_CODE     4      // ModemConfig1[3:1]: 4 = 4/8
+#define LORA_PREAMBLE    12     // Símbolos de preâmbulo programados
+#define CAD_SYMBOLS      2      // CAD do LBT dos nós, como em hardware/firmware/lora_RFM95.c
+
+// Parâmetros do FSK dos despejos: devem ser iguais aos do transmissor
+#define FSK_BITRATE_BPS  250000
+#define FSK_FDEV_STEPS   2048   // 125 kHz em passos de Fxosc / 2^19: índice de modulação 1
+#define FSK_RX_BW        0x01   // Mantissa 16, expoente 1: 250 kHz >= Fdev + BR/2
+#define FSK_PREAMBLE     5      // Bytes de preâmbulo
+#define FSK_TX_TIMEOUT_MS 20
+
+static const uint8_t fsk_sync[] = { 0x2D, 0xD4, 0x12 };
+
+// Endereços que lora_fsk_begin() escreve e que o modo LoRa também lê
+// (0x31 é RegDetectOptimize, 0x1F RegSymbTimeoutLsb, 0x40 o mapa dos DIO...):
+// guardados antes do despejo e devolvidos por lora_fsk_end()
+static const uint8_t fsk_shared_regs[] = {
+    REG_BITRATE_MSB, REG_BITRATE_LSB, REG_FDEV_MSB, REG_FDEV_LSB, REG_PA_RAMP,
+    REG_RX_CONFIG, REG_RX_BW, REG_AFC_BW, REG_PREAMBLE_DETECT,
+    REG_FSK_PREAMBLE_MSB, REG_FSK_PREAMBLE_LSB, REG_SYNC_CONFIG,
+    REG_SYNC_VALUE_1, REG_SYNC_VALUE_1 + 1, REG_SYNC_VALUE_1 + 2,
+    REG_PACKET_CONFIG_1, REG_PACKET_CONFIG_2, REG_FSK_PAYLOAD_LENGTH,
+    REG_FIFO_THRESH, REG_DIO_MAPPING_1,
+};
+static uint8_t lora_shared_saved[sizeof(fsk_shared_regs)];
+
 
 // ============================
 // VARIÁVEIS PRIVADAS (STATIC)
@@ -57,6 +114,12 @@ static lora_config_t lora;
 volatile static bool tx_done = false;
 volatile static bool rx_done = false;
 volatile static bool dio0_event = false;
+static bool tx_active = false;          // Envio assíncrono em andamento
+static uint8_t lora_sf = LORA_SF;
+static uint8_t lora_implicit_len = 0;   // 0: cabeçalho explícito
+static uint8_t lora_channel = LORA_BEACON_CHANNEL;
+static bool lora_fsk = false;           // Modem FSK no lugar do LoRa (despejo)
+static absolute_time_t tx_deadline;
 
 // ============================
 // PROTÓTIPOS DE FUNÇÕES PRIVADAS
@@ -64,6 +127,7 @@ volatile static bool dio0_event = false;
 static void lora_reset();
 static void lora_write_reg(uint8_t reg, uint8_t value);
 static uint8_t lora_read_reg(uint8_t reg);
+static void lora_write_burst(uint8_t reg, const uint8_t *data, uint8_t len);
 static void lora_write_fifo(const uint8_t *data, uint8_t len);
 static void lora_read_fifo(uint8_t *data, uint8_t len);
 static void lora_set_mode(uint8_t mode);
@@ -72,12 +136,33 @@ static void cs_deselect();
 static void dio0_irq_handler(uint gpio, uint32_t events);
 static void handle_dio0_events();
 
+// Low Data Rate Optimize: obrigatório com símbolo de 16 ms ou mais (SF11 e
+// SF12 em 125 kHz); transmissor e receptor devem concordar
+static uint8_t lora_ldo(uint8_t sf) {
+    return ((1000000ull << sf) / LORA_BW_HZ) >= 16000 ? 1 : 0;
+}
+
 // ============================
 // IMPLEMENTAÇÃO DAS FUNÇÕES
 // ============================
 
 // --- Funções Públicas ---
 
+// Registradores do modem LoRa (0x0D a 0x3F), no boot e na volta do FSK
+static void lora_modem_config(void) {
+    lora_set_implicit_header(lora_implicit_len); // 0x78 no boot: BW 125kHz, CR 4/8, explícito
+    lora_set_sf(lora_sf);                        // SF12 no boot, CRC on, LDO on, AGC on
+    lora_write_reg(REG_PREAMBLE_MSB, 0x00);
+    lora_write_reg(REG_PREAMBLE_LSB, LORA_PREAMBLE);
+    lora_write_reg(0x39, 0x12);
+
+    // Outras configurações
+    lora_write_reg(REG_FIFO_TX_BASE_ADDR, 0x00);
+    lora_write_reg(REG_FIFO_RX_BASE_ADDR, 0x00);
+    lora_write_reg(REG_IRQ_FLAGS_MASK, 0x00); // Libera todas as IRQs
+    lora_write_reg(REG_IRQ_FLAGS, 0xFF); // Limpa IRQs
+}
+
 bool lora_init(lora_config_t config) {
     lora = config; // Copia a configuração para a variável estática
 
@@ -100,29 +185,14 @@ bool lora_init(lora_config_t config) {
 
     lora_write_reg(REG_IRQ_FLAGS, 0xFF); // Limpa todas as flags de IRQ
     
-    uint64_t frf = ((uint64_t)lora.frequency << 19) / 32000000;
-    lora_write_reg(REG_FRF_MSB, (uint8_t)(frf >> 16));
-    lora_write_reg(REG_FRF_MID, (uint8_t)(frf >> 8));
-    lora_write_reg(REG_FRF_LSB, (uint8_t)(frf >> 0));
+    lora_set_channel(lora.channel);
 
     // Configurações para longo alcance e robustez
     lora_write_reg(REG_PA_CONFIG, 0xFF); // PaConfig: Max Power (+17dBm on PA_BOOST)
     lora_write_reg(REG_PA_DAC, 0x87); // PaDac: Ativa +20dBm
-    lora_write_reg(REG_MODEM_CONFIG_1, 0x78); // ModemConfig1: BW 62.5kHz, CR 4/8
-    lora_write_reg(REG_MODEM_CONFIG_2, 0xC4); // ModemConfig2: SF12, CRC on
-    lora_write_reg(REG_MODEM_CONFIG_3, 0x0C); // ModemConfig3: LDO on, AGC on
-    lora_write_reg(REG_PREAMBLE_MSB, 0x00);
-    lora_write_reg(REG_PREAMBLE_LSB, 0x0C);
-
     lora_write_reg(0x0B, 0x37); // OCP default
-    lora_write_reg(0x39, 0x12);
-
-    // Outras configurações
-    lora_write_reg(REG_FIFO_TX_BASE_ADDR, 0x00);
-    lora_write_reg(REG_FIFO_RX_BASE_ADDR, 0x00);
     lora_write_reg(REG_LNA, 0x23); // LNA boost para RX
-    lora_write_reg(REG_IRQ_FLAGS_MASK, 0x00); // Libera todas as IRQs
-    lora_write_reg(REG_IRQ_FLAGS, 0xFF); // Limpa IRQs
+    lora_modem_config();
     
     //lora_set_mode(MODE_STDBY);
     
@@ -180,7 +250,15 @@ int lora_receive(char *buf, size_t maxlen) {
 
 // <<< ADICIONAR IMPLEMENTAÇÃO DAS NOVAS FUNÇÕES >>>
 bool lora_send_bytes(const uint8_t *data, size_t len) {
-    if (len > 255) return false;
+    if (!lora_send_bytes_async(data, len)) return false;
+    while (lora_tx_busy()) {
+        tight_loop_contents();
+    }
+    return tx_done;
+}
+
+bool lora_send_bytes_async(const uint8_t *data, size_t len) {
+    if (len > 255 || tx_active) return false;
 
     lora_set_mode(MODE_STDBY);
     lora_write_reg(REG_FIFO_ADDR_PTR, 0x00);
@@ -191,20 +269,21 @@ bool lora_send_bytes(const uint8_t *data, size_t len) {
     lora_write_reg(REG_DIO_MAPPING_1, 0x40); // DIO0 -> TxDone
 
     tx_done = false;
+    tx_active = true;
+    tx_deadline = make_timeout_time_ms(TX_TIMEOUT_MS);
     lora_set_mode(MODE_TX);
+    return true;
+}
 
-    absolute_time_t start_time = get_absolute_time();
-    while (!tx_done) {
-        handle_dio0_events();
-        if (absolute_time_diff_us(start_time, get_absolute_time()) > (TX_TIMEOUT_MS * 1000)) {
-            lora_set_mode(MODE_STDBY);
-            return false;
-        }
-        tight_loop_contents();
-    }
+bool lora_tx_busy(void) {
+    if (!tx_active) return false;
 
-    lora_set_mode(MODE_STDBY);
-    return true;
+    handle_dio0_events();
+    if (tx_done || time_reached(tx_deadline)) {
+        lora_set_mode(MODE_STDBY); // Fim do envio (ou aborta no timeout)
+        tx_active = false;
+    }
+    return tx_active;
 }
 
 int lora_receive_bytes(uint8_t *buf, size_t maxlen) {
@@ -227,6 +306,41 @@ int lora_receive_bytes(uint8_t *buf, size_t maxlen) {
 }
 
 
+void lora_set_sf(uint8_t sf) {
+    if (sf < LORA_SF_MIN) sf = LORA_SF_MIN;
+    if (sf > LORA_SF_MAX) sf = LORA_SF_MAX;
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_MODEM_CONFIG_2, (uint8_t)((sf << 4) | 0x04)); // CRC on
+    lora_write_reg(REG_MODEM_CONFIG_3, (uint8_t)((lora_ldo(sf) << 3) | 0x04)); // AGC on
+    lora_sf = sf;
+}
+
+uint8_t lora_get_sf(void) {
+    return lora_sf;
+}
+
+// No cabeçalho implícito o RxDone sai com RegPayloadLength bytes, sem ler
+// tamanho, CR e CRC do ar; o transmissor precisa estar no mesmo modo
+void lora_set_implicit_header(uint8_t len) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_MODEM_CONFIG_1, (uint8_t)((LORA_BW_CODE << 4) | (LORA_CR_CODE << 1) | (len ? 0x01 : 0x00)));
+    if (len) lora_write_reg(REG_PAYLOAD_LENGTH, len);
+    lora_implicit_len = len;
+}
+
+uint8_t lora_get_implicit_header(void) {
+    return lora_implicit_len;
+}
+
+void lora_set_channel(uint8_t channel) {
+    const uint32_t frf = lora_channel_frf[channel % LORA_CHANNEL_COUNT];
+    const uint8_t bytes[3] = { (uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf };
+
+    lora_set_mode(MODE_STDBY); // RegFrf só muda fora de RX/TX
+    lora_write_burst(REG_FRF_MSB, bytes, sizeof(bytes));
+    lora_channel = channel;
+}
+
 void lora_start_rx_continuous(void) {
     lora_write_reg(REG_IRQ_FLAGS, 0xFF);
     lora_write_reg(REG_DIO_MAPPING_1, 0x00); // DIO0 -> RxDone
@@ -234,6 +348,100 @@ void lora_start_rx_continuous(void) {
     lora_set_mode(MODE_RX_CONTINUOUS);
 }
 
+// --- FSK (despejos) ---
+
+// LongRangeMode só muda em sleep
+void lora_fsk_begin(void) {
+    const uint32_t frf = LORA_FRF(FSK_BULK_HZ);
+    const uint8_t frf_bytes[3] = { (uint8_t)(frf >> 16), (uint8_t)(frf >> 8), (uint8_t)frf };
+    const uint16_t bitrate = LORA_FXOSC_HZ / FSK_BITRATE_BPS;
+
+    lora_set_mode(MODE_SLEEP);
+    for (size_t i = 0; i < sizeof(fsk_shared_regs); i++)
+        lora_shared_saved[i] = lora_read_reg(fsk_shared_regs[i]);
+    lora_fsk = true;
+    lora_set_mode(MODE_SLEEP);
+
+    lora_write_burst(REG_FRF_MSB, frf_bytes, sizeof(frf_bytes));
+    lora_write_reg(REG_BITRATE_MSB, (uint8_t)(bitrate >> 8));
+    lora_write_reg(REG_BITRATE_LSB, (uint8_t)bitrate);
+    lora_write_reg(REG_FDEV_MSB, (uint8_t)(FSK_FDEV_STEPS >> 8));
+    lora_write_reg(REG_FDEV_LSB, (uint8_t)FSK_FDEV_STEPS);
+    lora_write_reg(REG_PA_RAMP, 0x49);          // Gaussiano BT 0.5, rampa de 40 us
+    lora_write_reg(REG_RX_CONFIG, 0x1E);        // AFC e AGC automáticos, RX dispara no preâmbulo
+    lora_write_reg(REG_RX_BW, FSK_RX_BW);
+    lora_write_reg(REG_AFC_BW, FSK_RX_BW);
+    lora_write_reg(REG_PREAMBLE_DETECT, 0xAA);  // Detector ligado, 2 bytes
+    lora_write_reg(REG_FSK_PREAMBLE_MSB, 0x00);
+    lora_write_reg(REG_FSK_PREAMBLE_LSB, FSK_PREAMBLE);
+    lora_write_reg(REG_SYNC_CONFIG, (uint8_t)(0x50 | (sizeof(fsk_sync) - 1))); // Reinício automático do RX
+    lora_write_burst(REG_SYNC_VALUE_1, fsk_sync, sizeof(fsk_sync));
+    lora_write_reg(REG_PACKET_CONFIG_1, 0xD0);  // Tamanho variável, whitening, CRC
+    lora_write_reg(REG_PACKET_CONFIG_2, 0x40);  // Modo pacote
+    lora_write_reg(REG_FSK_PAYLOAD_LENGTH, LORA_FSK_MAX_LEN); // Maior pacote aceito
+    lora_write_reg(REG_FIFO_THRESH, 0x8F);      // TX começa com o FIFO não vazio
+    lora_write_reg(REG_DIO_MAPPING_1, 0x00);
+    lora_set_mode(MODE_STDBY);
+}
+
+void lora_fsk_end(void) {
+    lora_set_mode(MODE_SLEEP);
+    lora_fsk = false;
+    lora_set_mode(MODE_SLEEP);
+    for (size_t i = 0; i < sizeof(fsk_shared_regs); i++)
+        lora_write_reg(fsk_shared_regs[i], lora_shared_saved[i]);
+    lora_modem_config();
+    lora_set_channel(lora_channel);
+    dio0_event = false; // Sobra do PacketSent/PayloadReady do FSK
+}
+
+bool lora_fsk_send(const uint8_t *data, size_t len) {
+    if (len == 0 || len > LORA_FSK_MAX_LEN) return false;
+
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_IRQ_FLAGS_2, IRQ2_FIFO_OVERRUN); // Esvazia o FIFO
+    lora_write_reg(REG_FIFO, (uint8_t)len);
+    lora_write_fifo(data, (uint8_t)len);
+    lora_set_mode(MODE_TX);
+
+    absolute_time_t deadline = make_timeout_time_ms(FSK_TX_TIMEOUT_MS);
+    while (!time_reached(deadline)) {
+        if (lora_read_reg(REG_IRQ_FLAGS_2) & IRQ2_PACKET_SENT) {
+            lora_set_mode(MODE_STDBY);
+            return true;
+        }
+    }
+    lora_set_mode(MODE_STDBY); // Aborta TX
+    return false;
+}
+
+void lora_fsk_start_rx(void) {
+    lora_set_mode(MODE_STDBY);
+    lora_write_reg(REG_IRQ_FLAGS_2, IRQ2_FIFO_OVERRUN);
+    lora_set_mode(MODE_RX_CONTINUOUS);
+}
+
+// PayloadReady só sobe com o CRC certo; o FIFO começa pelo byte de tamanho
+int lora_fsk_receive(uint8_t *buf, size_t maxlen) {
+    if (!(lora_read_reg(REG_IRQ_FLAGS_2) & IRQ2_PAYLOAD_READY)) return 0;
+
+    uint8_t len = lora_read_reg(REG_FIFO);
+    if (len > LORA_FSK_MAX_LEN) len = LORA_FSK_MAX_LEN;
+    if (len > maxlen) {
+        uint8_t discard[LORA_FSK_MAX_LEN];
+        lora_read_fifo(discard, len);
+        return 0;
+    }
+    lora_read_fifo(buf, len);
+    return len;
+}
+
+// Preâmbulo, sync, tamanho, payload e CRC, bit a bit
+uint32_t lora_fsk_time_on_air_us(size_t len) {
+    const uint32_t bits = 8 * (FSK_PREAMBLE + sizeof(fsk_sync) + 1 + (uint32_t)len + 2);
+    return (uint32_t)((uint64_t)bits * 1000000 / FSK_BITRATE_BPS);
+}
+
 // --- Funções Privadas ---
 
 static void cs_select() { gpio_put(lora.pin_cs, 0); }
@@ -260,14 +468,20 @@ static uint8_t lora_read_reg(uint8_t reg) {
     return rx[1];
 }
 
-static void lora_write_fifo(const uint8_t *data, uint8_t len) {
+// Registradores consecutivos numa só seleção: o endereço avança sozinho
+// (exceto no FIFO, que recebe todos os bytes)
+static void lora_write_burst(uint8_t reg, const uint8_t *data, uint8_t len) {
     cs_select();
-    uint8_t addr = REG_FIFO | 0x80;
+    uint8_t addr = reg | 0x80;
     spi_write_blocking(lora.spi_instance, &addr, 1);
     spi_write_blocking(lora.spi_instance, data, len);
     cs_deselect();
 }
 
+static void lora_write_fifo(const uint8_t *data, uint8_t len) {
+    lora_write_burst(REG_FIFO, data, len);
+}
+
 static void lora_read_fifo(uint8_t *data, uint8_t len) {
     cs_select();
     uint8_t addr = REG_FIFO & 0x7F;
@@ -277,7 +491,7 @@ static void lora_read_fifo(uint8_t *data, uint8_t len) {
 }
 
 static void lora_set_mode(uint8_t mode) {
-    lora_write_reg(REG_OP_MODE, (0x80 | mode)); // Bit 7 (LongRangeMode) sempre deve ser 1
+    lora_write_reg(REG_OP_MODE, (lora_fsk ? 0x00 : 0x80) | mode); // Bit 7 (LongRangeMode): 1 no LoRa, 0 no FSK
 }
 
 static void dio0_irq_handler(uint gpio, uint32_t events) {
@@ -286,7 +500,7 @@ static void dio0_irq_handler(uint gpio, uint32_t events) {
 }
 
 static void handle_dio0_events() {
-    if (!dio0_event) return;
+    if (!dio0_event || lora_fsk) return; // No FSK as flags são outras e são consultadas direto
     dio0_event = false;
 
     uint8_t irq_flags = lora_read_reg(REG_IRQ_FLAGS);
@@ -308,5 +522,36 @@ int lora_get_rssi(void) {
     uint8_t rssi_raw = lora_read_reg(REG_PKT_RSSI_VALUE);
     // A fórmula para calcular o RSSI em dBm é RSSI = -157 + Rssi (para o frontend de HF)
     // Veja a seção 5.5.5 do datasheet do SX1276/7/8/9.
-    return rssi_raw - 157;
+    int rssi = rssi_raw - 157;
+
+    // Abaixo do ruído o registrador superestima: soma o SNR negativo
+    int snr = lora_get_snr();
+    return snr < 0 ? rssi + snr : rssi;
+}
+
+int lora_get_snr(void) {
+    int8_t snr_raw = (int8_t)lora_read_reg(REG_PKT_SNR_VALUE);
+    return snr_raw / 4; // Quartos de dB, arredondado em direção a zero
+}
+
+// Tempo no ar de um pacote, fórmula da seção 4.1.1.7 do datasheet SX1276
+uint32_t lora_time_on_air_us(size_t len) {
+    const uint32_t symbol_us = (uint32_t)((1000000ull << lora_sf) / LORA_BW_HZ);
+
+    // Preâmbulo: programado + 4.25 símbolos
+    uint32_t preamble_us = (LORA_PREAMBLE * 4 + 17) * symbol_us / 4;
+
+    // Payload com CRC ligado; o cabeçalho explícito (IH = 0) custa 20 bits
+    const int32_t ih = lora_implicit_len ? 1 : 0;
+    int32_t num = 8 * (int32_t)len - 4 * lora_sf + 28 + 16 - 20 * ih;
+    int32_t den = 4 * (lora_sf - 2 * lora_ldo(lora_sf));
+    int32_t blocks = num > 0 ? (num + den - 1) / den : 0;
+    uint32_t payload_symbols = 8 + (uint32_t)blocks * (LORA_CR_CODE + 4);
+
+    return preamble_us + payload_symbols * symbol_us;
+}
+
+// Duração de um CAD dos nós com o SF configurado (mesma conta do nó)
+uint32_t lora_cad_time_us(void) {
+    return CAD_SYMBOLS * (uint32_t)((1000000ull << lora_sf) / LORA_BW_HZ);
 }
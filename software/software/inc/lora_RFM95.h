@@ -13,6 +13,13 @@
 // ============================
 #define TX_TIMEOUT_MS       5000   // tempo máximo esperando TxDone
 
+// Faixa de lora_set_sf(); o boot e o beacon usam LORA_SF_MAX
+#define LORA_SF_MIN 7
+#define LORA_SF_MAX 12
+
+// Maior pacote FSK: o FIFO do modo FSK tem 64 bytes, com o byte de tamanho
+#define LORA_FSK_MAX_LEN 63
+
 // Struct de configuração para tornar a biblioteca mais portável
 typedef struct {
     spi_inst_t *spi_instance;
@@ -22,7 +29,7 @@ typedef struct {
     uint pin_mosi;
     uint pin_rst;
     uint pin_dio0;
-    long frequency; // Frequência em Hz (ex: 915E6)
+    uint8_t channel; // Canal inicial do plano (lora_channels.h)
 } lora_config_t;
 
 /**
@@ -47,6 +54,41 @@ bool lora_send(const char *msg);
  */
 int lora_receive(char *buf, size_t maxlen);
 
+/**
+ * @brief Sintoniza um canal do plano (lora_channels.h).
+ * Escreve os três bytes de RegFrf numa só transação SPI e deixa o rádio em
+ * standby; para voltar a ouvir, chame lora_start_rx_continuous().
+ * @param channel Canal, 0 .. LORA_CHANNEL_COUNT-1.
+ */
+void lora_set_channel(uint8_t channel);
+
+/**
+ * @brief Troca o spreading factor (BW e CR não mudam). Também ajusta o Low
+ * Data Rate Optimize e o tempo no ar de lora_time_on_air_us(). Deixa o
+ * rádio em standby.
+ * @param sf LORA_SF_MIN .. LORA_SF_MAX.
+ */
+void lora_set_sf(uint8_t sf);
+
+/**
+ * @brief Spreading factor em uso.
+ */
+uint8_t lora_get_sf(void);
+
+/**
+ * @brief Troca o modo de cabeçalho LoRa. No implícito o pacote vai sem o
+ * cabeçalho de tamanho/CR/CRC (20 bits a menos no ar) e só são recebidos
+ * pacotes de exatamente len bytes, enviados também em modo implícito.
+ * Deixa o rádio em standby.
+ * @param len Tamanho fixo dos pacotes (RegPayloadLength); 0: explícito.
+ */
+void lora_set_implicit_header(uint8_t len);
+
+/**
+ * @brief Tamanho do cabeçalho implícito em uso; 0: explícito.
+ */
+uint8_t lora_get_implicit_header(void);
+
 /**
  * @brief Coloca o rádio em modo de recepção contínua.
  */
@@ -60,6 +102,73 @@ void lora_start_rx_continuous(void);
  */
 bool lora_send_bytes(const uint8_t *data, size_t len);
 
+/**
+ * @brief Inicia o envio de um buffer de bytes e retorna sem esperar o TxDone.
+ * Acompanhe com lora_tx_busy(); depois volte à recepção com
+ * lora_start_rx_continuous().
+ * @param data Ponteiro para os dados (copiados para o FIFO antes de retornar).
+ * @param len Número de bytes a serem enviados.
+ * @return true se o envio foi iniciado, false se o tamanho é inválido ou
+ * outro envio ainda está em andamento.
+ */
+bool lora_send_bytes_async(const uint8_t *data, size_t len);
+
+/**
+ * @brief Indica se o envio iniciado por lora_send_bytes_async() continua.
+ * Não bloqueia; ao terminar (TxDone ou TX_TIMEOUT_MS) o rádio fica em standby.
+ * @return true enquanto o rádio está transmitindo.
+ */
+bool lora_tx_busy(void);
+
+/**
+ * @brief Tempo no ar de um pacote com a modulação configurada.
+ * @param len Tamanho do payload em bytes.
+ * @return Duração da transmissão em microssegundos, preâmbulo incluído.
+ */
+uint32_t lora_time_on_air_us(size_t len);
+
+/**
+ * @brief Duração de um CAD (Channel Activity Detection) dos nós com o SF
+ * configurado, para reservar o listen-before-talk no slot.
+ */
+uint32_t lora_cad_time_us(void);
+
+/**
+ * @brief Troca o modem para FSK (LongRangeMode = 0) no canal dos despejos
+ * (FSK_BULK_HZ): 250 kbps, pacotes de tamanho variável até
+ * LORA_FSK_MAX_LEN com CRC e whitening. As funções LoRa não valem até
+ * lora_fsk_end(). Deixa o rádio em standby.
+ */
+void lora_fsk_begin(void);
+
+/**
+ * @brief Volta ao modem LoRa com o canal, o SF e o modo de cabeçalho de
+ * antes do FSK. Deixa o rádio em standby.
+ */
+void lora_fsk_end(void);
+
+/**
+ * @brief Envia um pacote FSK e espera o PacketSent (poucos ms).
+ * @return true se o pacote saiu.
+ */
+bool lora_fsk_send(const uint8_t *data, size_t len);
+
+/**
+ * @brief Coloca o rádio em recepção FSK contínua.
+ */
+void lora_fsk_start_rx(void);
+
+/**
+ * @brief Verifica se chegou um pacote FSK com CRC correto. Não bloqueante.
+ * @return Tamanho do pacote, ou 0 se nada chegou (ou não coube em maxlen).
+ */
+int lora_fsk_receive(uint8_t *buf, size_t maxlen);
+
+/**
+ * @brief Tempo no ar de um pacote FSK, preâmbulo e CRC incluídos.
+ */
+uint32_t lora_fsk_time_on_air_us(size_t len);
+
 /**
  * @brief Tenta receber um buffer de bytes.
  * @param buf Buffer para armazenar os dados.
@@ -74,4 +183,10 @@ int lora_receive_bytes(uint8_t *buf, size_t maxlen);
  */
 int lora_get_rssi(void); // <<< ADICIONE ESTA LINHA
 
+/**
+ * @brief SNR do último pacote recebido (REG_PKT_SNR_VALUE).
+ * @return SNR em dB; negativo com o sinal abaixo do ruído.
+ */
+int lora_get_snr(void);
+
 #endif // LORA_RFM95_H_
\ No newline at end of file
@@ -0,0 +1,71 @@
+// lora_channels.h
+//
+// Plano de canais e sequência de saltos de frequência da rede, comuns ao
+// gateway e aos nós. Há uma cópia em cada lado (hardware/firmware e
+// software/software/inc): as duas devem ser mantidas iguais.
+//
+// Os valores de RegFrf saem prontos da compilação: trocar de canal é só
+// escrever três registradores, sem a divisão de 64 bits em tempo de
+// execução.
+#ifndef LORA_CHANNELS_H_
+#define LORA_CHANNELS_H_
+
+#include <stdint.h>
+
+// ============================
+// === Plano de Canais ===
+// ============================
+// Sub-banda 1 do AU915 (plano LoRaWAN usado no Brasil): 8 canais de
+// 125 kHz a cada 200 kHz, de 915,2 a 916,6 MHz
+#define LORA_CHANNEL_COUNT    8
+#define LORA_CHANNEL_BASE_HZ  915200000u
+#define LORA_CHANNEL_STEP_HZ  200000u
+#define LORA_CHANNEL_HZ(ch)   (LORA_CHANNEL_BASE_HZ + (uint32_t)(ch) * LORA_CHANNEL_STEP_HZ)
+
+// Palavra de 24 bits de RegFrf: Frf = f * 2^19 / Fxosc (32 MHz)
+#define LORA_FXOSC_HZ 32000000u
+#define LORA_FRF(hz)  ((uint32_t)(((uint64_t)(hz) << 19) / LORA_FXOSC_HZ))
+
+static const uint32_t lora_channel_frf[LORA_CHANNEL_COUNT] = {
+    LORA_FRF(LORA_CHANNEL_HZ(0)), LORA_FRF(LORA_CHANNEL_HZ(1)),
+    LORA_FRF(LORA_CHANNEL_HZ(2)), LORA_FRF(LORA_CHANNEL_HZ(3)),
+    LORA_FRF(LORA_CHANNEL_HZ(4)), LORA_FRF(LORA_CHANNEL_HZ(5)),
+    LORA_FRF(LORA_CHANNEL_HZ(6)), LORA_FRF(LORA_CHANNEL_HZ(7)),
+};
+
+_Static_assert(LORA_FRF(915000000u) == 0xE4C000, "RegFrf de 915 MHz");
+
+// Despejos do log em FSK (lora_fsk_begin()): canal único fora do plano,
+// com folga para os ~500 kHz ocupados a 250 kbps
+#define FSK_BULK_HZ 917400000u
+
+// ============================
+// === Saltos ===
+// ============================
+// O beacon fica sempre no mesmo canal, onde os nós sem sincronismo o
+// procuram. Os slots dos nós saltam por um canal diferente a cada slot,
+// com deslocamento pseudoaleatório a cada superquadro.
+#define LORA_BEACON_CHANNEL 0
+
+// Semente da sequência: redes vizinhas com sementes diferentes saltam por
+// caminhos diferentes. Gateway e nós devem usar a mesma.
+#ifndef LORA_HOP_SEED
+#define LORA_HOP_SEED 0x5A17u
+#endif
+
+/**
+ * @brief Canal de um slot TDMA.
+ * @param superframe seq do beacon do superquadro.
+ * @param slot Slot no superquadro (0: beacon).
+ * @param hop_channels Canais em uso (frame_beacon_t); 0 ou 1: sem saltos.
+ */
+static inline uint8_t lora_hop_channel(uint16_t superframe, uint8_t slot, uint8_t hop_channels) {
+    if (slot == 0 || hop_channels < 2) return LORA_BEACON_CHANNEL;
+
+    // Mistura multiplicativa (Fibonacci) do número do superquadro
+    uint32_t x = ((uint32_t)superframe ^ LORA_HOP_SEED) * 0x9E3779B1u;
+    x ^= x >> 16;
+    return (uint8_t)((x + slot) % hop_channels);
+}
+
+#endif // LORA_CHANNELS_H_
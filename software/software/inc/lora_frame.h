@@ -0,0 +1,221 @@
+// lora_frame.h
+//
+// Formato dos quadros LoRa entre os nós FPGA e o receptor Pico.
+// Há uma cópia em cada lado (hardware/firmware e software/software/inc):
+// as duas devem ser mantidas iguais.
+#ifndef LORA_FRAME_H_
+#define LORA_FRAME_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ============================
+// === Endereços ===
+// ============================
+#define FRAME_NODE_GATEWAY   0x00 // Receptor Pico
+#define FRAME_NODE_BROADCAST 0xFF // Todos os nós
+
+// ============================
+// === Tipos e Flags ===
+// ============================
+// O tipo ocupa os 4 bits altos de type_flags e as flags os 4 baixos
+typedef enum {
+    FRAME_TYPE_SENSOR   = 0x1, // frame_sensor_t
+    FRAME_TYPE_BEACON   = 0x2, // frame_beacon_t, do gateway para FRAME_NODE_BROADCAST
+    FRAME_TYPE_BATCH    = 0x3, // frame_batch_t, amostras com seq próprio (ARQ)
+    FRAME_TYPE_ACK      = 0x4, // frame_ack_t, do gateway para o nó
+    FRAME_TYPE_PARITY   = 0x5, // frame_parity_t, redundância de um grupo de quadros
+    FRAME_TYPE_BULK     = 0x6, // frame_bulk_t, fragmento do log em FSK
+    FRAME_TYPE_BULK_ACK = 0x7, // frame_bulk_ack_t, confirmação de uma rodada de fragmentos
+} frame_type_t;
+
+#define FRAME_FLAG_RESET   0x1 // Primeiro quadro desde o boot: seq recomeçou
+#define FRAME_FLAG_ACK_REQ 0x2 // O nó abre a janela de recepção e espera um ACK
+#define FRAME_FLAG_FEC     0x4 // Quadro protegido por paridade (frame_parity_t)
+#define FRAME_FLAG_IMPLICIT 0x8 // O nó aceita cabeçalho implícito no seu slot
+
+// Lote e ACK: pedido e concessão de um despejo do log em FSK (frame_bulk_t).
+// Mesmo bit de FRAME_FLAG_FEC, que só vale nos quadros de sensor.
+#define FRAME_FLAG_BULK    0x4
+
+// Atraso máximo entre o fim de um quadro com FRAME_FLAG_ACK_REQ e o início
+// do ACK: o nó escuta por esse tempo mais o tempo no ar do ACK
+#define FRAME_ACK_DELAY_MAX_MS 200
+
+#define FRAME_TYPE_FLAGS(type, flags) ((uint8_t)(((type) << 4) | ((flags) & 0x0F)))
+#define FRAME_TYPE(h)                 ((h)->type_flags >> 4)
+#define FRAME_FLAGS(h)                ((h)->type_flags & 0x0F)
+
+// ============================
+// === Quadros ===
+// ============================
+// Campos little-endian (RISC-V e ARM), sem preenchimento entre eles
+
+/**
+ * @brief Cabeçalho de 4 bytes no início de todo quadro.
+ */
+typedef struct {
+    uint8_t node_id;    // Origem (ou destino, nos quadros do gateway)
+    uint8_t type_flags; // FRAME_TYPE_FLAGS()
+    uint16_t seq;       // Sequência por nó, volta a zero após 65535
+} frame_header_t;
+
+/**
+ * @brief Leitura do AHT10, valores multiplicados por 100.
+ */
+typedef struct {
+    frame_header_t header;
+    int16_t temperatura;
+    int16_t umidade;
+} frame_sensor_t;
+
+/**
+ * @brief Início de um superquadro TDMA, enviado pelo gateway no slot 0.
+ * Os slots seguintes (1 .. slot_count-1) são dos nós; cada nó transmite só
+ * no seu (frame_tdma_slot()). O seq do cabeçalho numera os superquadros.
+ * Com hop_channels > 1 cada slot de nó usa o canal de lora_hop_channel().
+ * Os slots marcados em implicit_slots levam só quadros de sensor em
+ * cabeçalho implícito (FRAME_IMPLICIT_LEN); os demais, cabeçalho explícito.
+ */
+typedef struct {
+    frame_header_t header;
+    uint32_t timestamp_ms;   // Relógio do gateway no início do beacon
+    uint16_t slot_ms;        // Duração de cada slot, beacon incluído
+    uint8_t slot_count;      // Slots no superquadro, beacon incluído
+    uint8_t hop_channels;    // Canais dos saltos (lora_channels.h); 0: canal do beacon
+    uint16_t implicit_slots; // Bit s: slot s em cabeçalho implícito
+} frame_beacon_t;
+
+// Bytes do beacon no ar, sem o preenchimento final do struct: 14 bytes
+// cabem nos mesmos símbolos de SF12 que 12, e 16 custariam mais um bloco
+#define FRAME_BEACON_LEN (offsetof(frame_beacon_t, implicit_slots) + sizeof(uint16_t))
+
+// Cabeçalho implícito: o rádio não manda tamanho, CR e CRC, então os dois
+// lados precisam saber o tamanho antes. Só o quadro de sensor, de tamanho
+// fixo, usa esse modo, e só depois que o nó anunciou FRAME_FLAG_IMPLICIT e
+// o gateway marcou o slot no beacon. Beacon, ACK, lote e paridade seguem
+// sempre em cabeçalho explícito.
+#define FRAME_IMPLICIT_LEN sizeof(frame_sensor_t)
+
+// Amostras por quadro em lote
+#define FRAME_BATCH_MAX 4
+
+/**
+ * @brief Uma leitura do AHT10 com número de amostra, para o ARQ.
+ */
+typedef struct {
+    uint16_t seq;        // Sequência de amostras do nó (independe do seq do quadro)
+    int16_t temperatura;
+    int16_t umidade;
+} frame_sample_t;
+
+/**
+ * @brief Lote de 1 a FRAME_BATCH_MAX amostras, a mais antiga primeiro.
+ * Enviado só com as amostras presentes: 6 + 6 * n bytes.
+ */
+typedef struct {
+    frame_header_t header;
+    uint8_t adr;         // Taxa e potência em uso no nó (FRAME_ADR()): confirma o comando do ACK
+    uint8_t reserved;    // Zero
+    frame_sample_t samples[FRAME_BATCH_MAX];
+} frame_batch_t;
+
+#define FRAME_BATCH_LEN(n)   (offsetof(frame_batch_t, samples) + (n) * sizeof(frame_sample_t))
+#define FRAME_BATCH_COUNT(len) (((len) - FRAME_BATCH_LEN(0)) / sizeof(frame_sample_t))
+
+/**
+ * @brief Confirmação seletiva do gateway, com configuração de carona.
+ * O bitmap cobre as 16 amostras mais recentes recebidas do nó, inclusive
+ * as de quadros anteriores cujo ACK se perdeu.
+ */
+typedef struct {
+    frame_header_t header; // node_id: destino; seq: o do quadro confirmado
+    uint16_t base_seq;     // Amostra mais nova recebida
+    uint16_t bitmap;       // Bit i: amostra base_seq - i recebida
+    uint8_t interval;      // Superquadros entre amostras (0: sem mudança)
+    uint8_t adr;           // Taxa e potência para o nó (FRAME_ADR()); 0: sem comando
+} frame_ack_t;
+
+// Comando de ADR no ACK: spreading factor no nibble alto e potência no
+// baixo, em passos de 2 dB abaixo de 20 dBm. O SF vale a partir do próximo
+// superquadro e é o que o gateway vai ouvir no slot do nó. O nó devolve no
+// campo adr dos lotes o que de fato usou; um comando só vale para o gateway
+// depois desse relato.
+#define FRAME_ADR(sf, power_dbm) ((uint8_t)(((sf) << 4) | (((20 - (power_dbm)) / 2) & 0x0F)))
+#define FRAME_ADR_SF(adr)        ((uint8_t)((adr) >> 4))
+#define FRAME_ADR_POWER_DBM(adr) ((int8_t)(20 - 2 * ((adr) & 0x0F)))
+
+// Correção de erros entre quadros: até FRAME_FEC_MAX_K quadros de dados
+// por grupo e até FRAME_FEC_MAX_M quadros de paridade, que recuperam o
+// mesmo número de quadros perdidos (fec.h). Cada quadro de dados entra na
+// paridade como um símbolo [tamanho][bytes do quadro], completado com zeros.
+#define FRAME_FEC_MAX_K      8
+#define FRAME_FEC_MAX_M      4
+#define FRAME_FEC_SYMBOL_MAX 32
+
+// Despejo do log: quando o gateway concede (FRAME_FLAG_BULK no ACK), nó e
+// gateway trocam para FSK no resto do slot do nó. O nó manda as leituras
+// guardadas em janelas de até FRAME_BULK_WINDOW fragmentos, o último de
+// cada rodada com FRAME_FLAG_ACK_REQ, e reenvia os que o frame_bulk_ack_t
+// não confirmar. Os quadros FSK cabem no FIFO de 64 bytes.
+#define FRAME_BULK_SAMPLES 9
+#define FRAME_BULK_WINDOW  16
+
+/**
+ * @brief Fragmento de um despejo: até FRAME_BULK_SAMPLES leituras do log,
+ * a mais antiga primeiro. Enviado só com as leituras presentes:
+ * FRAME_BULK_LEN(n).
+ */
+typedef struct {
+    frame_header_t header; // seq: número do fragmento no despejo
+    uint16_t window;       // seq do primeiro fragmento da janela
+    frame_sample_t samples[FRAME_BULK_SAMPLES];
+} frame_bulk_t;
+
+#define FRAME_BULK_LEN(n)     (sizeof(frame_header_t) + sizeof(uint16_t) + (n) * sizeof(frame_sample_t))
+#define FRAME_BULK_COUNT(len) (((len) - FRAME_BULK_LEN(0)) / sizeof(frame_sample_t))
+
+/**
+ * @brief Confirmação de uma rodada de fragmentos, do gateway para o nó.
+ */
+typedef struct {
+    frame_header_t header; // node_id: destino; seq: window dos fragmentos
+    uint16_t bitmap;       // Bit i: fragmento window + i recebido
+} frame_bulk_ack_t;
+
+/**
+ * @brief Uma linha de paridade de um grupo de k quadros de dados
+ * consecutivos (seq .. seq + k - 1) do mesmo nó.
+ * Enviado só com symbol_len bytes de paridade: FRAME_PARITY_LEN(symbol_len).
+ */
+typedef struct {
+    frame_header_t header;  // seq: primeiro quadro do grupo
+    uint8_t k;              // Quadros de dados no grupo
+    uint8_t m;              // Quadros de paridade no grupo
+    uint8_t row;            // Esta linha (0 .. m-1)
+    uint8_t symbol_len;     // Bytes de paridade a seguir
+    uint8_t parity[FRAME_FEC_SYMBOL_MAX];
+} frame_parity_t;
+
+#define FRAME_PARITY_LEN(symbol_len) (sizeof(frame_header_t) + 4 + (symbol_len))
+
+_Static_assert(sizeof(frame_header_t) == 4, "frame_header_t deve ter 4 bytes");
+_Static_assert(sizeof(frame_sensor_t) == 8, "frame_sensor_t deve ter 8 bytes");
+_Static_assert(FRAME_BEACON_LEN == 14, "frame_beacon_t deve ter 14 bytes");
+_Static_assert(sizeof(frame_batch_t) == FRAME_BATCH_LEN(FRAME_BATCH_MAX), "frame_batch_t sem preenchimento");
+_Static_assert(sizeof(frame_ack_t) == 10, "frame_ack_t deve ter 10 bytes");
+_Static_assert(sizeof(frame_parity_t) == FRAME_PARITY_LEN(FRAME_FEC_SYMBOL_MAX), "frame_parity_t sem preenchimento");
+_Static_assert(FRAME_BATCH_LEN(FRAME_BATCH_MAX) < FRAME_FEC_SYMBOL_MAX, "lote cheio deve caber num símbolo");
+_Static_assert(sizeof(frame_bulk_t) == FRAME_BULK_LEN(FRAME_BULK_SAMPLES), "frame_bulk_t sem preenchimento");
+_Static_assert(sizeof(frame_bulk_t) < 64, "fragmento deve caber no FIFO do FSK com o byte de tamanho");
+_Static_assert(FRAME_BULK_WINDOW <= 16, "bitmap de frame_bulk_ack_t");
+
+/**
+ * @brief Slot TDMA de um nó: os nós se revezam nos slots depois do beacon.
+ * @param node_id De 1 a 254: o 0 (gateway) daria o slot 0, do beacon.
+ */
+static inline uint8_t frame_tdma_slot(uint8_t node_id, uint8_t slot_count) {
+    return (uint8_t)(1 + (node_id - 1) % (slot_count - 1));
+}
+
+#endif // LORA_FRAME_H_
@@ -0,0 +1,232 @@
+// node_table.c
+
+#include <stdio.h>
+#include <string.h>
+#include "node_table.h"
+
+static node_stats_t nodes[NODE_TABLE_SIZE];
+
+void node_table_reset(void) {
+    memset(nodes, 0, sizeof(nodes));
+}
+
+node_stats_t *node_table_find(uint8_t node_id) {
+    for (int i = 0; i < NODE_TABLE_SIZE; i++) {
+        if (nodes[i].in_use && nodes[i].node_id == node_id) return &nodes[i];
+    }
+    return NULL;
+}
+
+node_stats_t *node_table_at(int index) {
+    if (index < 0 || index >= NODE_TABLE_SIZE || !nodes[index].in_use) return NULL;
+    return &nodes[index];
+}
+
+static node_stats_t *node_table_add(uint8_t node_id) {
+    for (int i = 0; i < NODE_TABLE_SIZE; i++) {
+        if (!nodes[i].in_use) {
+            memset(&nodes[i], 0, sizeof(nodes[i]));
+            nodes[i].node_id = node_id;
+            nodes[i].in_use = true;
+            return &nodes[i];
+        }
+    }
+    return NULL;
+}
+
+// Intervalo desde o quadro anterior; a variação entre intervalos
+// consecutivos alimenta o jitter (mesma média do RTP, RFC 3550)
+static void node_stats_arrival(node_stats_t *n, uint64_t now_us) {
+    if (n->received > 0) {
+        uint64_t delta = now_us - n->last_rx_us;
+        uint32_t interval = delta > UINT32_MAX ? UINT32_MAX : (uint32_t)delta;
+
+        if (n->interval_count == 0 || interval < n->interval_min_us) n->interval_min_us = interval;
+        if (interval > n->interval_max_us) n->interval_max_us = interval;
+        if (n->interval_count > 0) {
+            int32_t d = (int32_t)(interval - n->last_interval_us);
+            if (d < 0) d = -d;
+            n->jitter_us += ((int32_t)d - (int32_t)n->jitter_us) / 16;
+        }
+        n->interval_sum_us += interval;
+        n->interval_count++;
+        n->last_interval_us = interval;
+    }
+    n->last_rx_us = now_us;
+    n->received++;
+}
+
+// Sequência, janela de recebidos e perdas; comum a quadros do rádio e
+// reconstruídos. Só quadros do rádio podem sinalizar um reinício.
+static node_rx_result_t node_table_account(const frame_header_t *header, bool over_air, node_stats_t **node) {
+    node_stats_t *n = node_table_find(header->node_id);
+
+    if (!n) {
+        n = node_table_add(header->node_id);
+        *node = n;
+        if (!n) return NODE_RX_TABLE_FULL;
+        n->last_seq = header->seq;
+        n->seq_window = 1;
+        return NODE_RX_FIRST;
+    }
+    *node = n;
+
+    // Distância com sinal: a sequência de 16 bits dá a volta
+    int16_t diff = (int16_t)(header->seq - n->last_seq);
+
+    if (over_air && (FRAME_FLAGS(header) & FRAME_FLAG_RESET)) {
+        // Repetição do mesmo quadro de boot não é um novo reinício
+        if (diff == 0) {
+            n->duplicates++;
+            return NODE_RX_DUPLICATE;
+        }
+    } else if (diff > 0) {
+        n->lost += (uint32_t)(diff - 1);
+        n->seq_window = diff >= 32 ? 1 : (n->seq_window << diff) | 1;
+        n->last_seq = header->seq;
+        return NODE_RX_OK;
+    } else if (diff >= -NODE_DUP_WINDOW) {
+        const uint32_t bit = 1u << (uint32_t)(-diff);
+        if (n->seq_window & bit) {
+            n->duplicates++;
+            return NODE_RX_DUPLICATE;
+        }
+        // Contado como perdido quando o seguinte chegou
+        n->seq_window |= bit;
+        if (n->lost > 0) n->lost--;
+        return NODE_RX_LATE;
+    } else if (!over_air) {
+        // Antigo demais para a janela: já não há como saber se é repetido
+        n->duplicates++;
+        return NODE_RX_DUPLICATE;
+    }
+
+    n->resets++;
+    n->have_samples = false; // As amostras também recomeçam
+    n->adr_sf = 0;           // O nó volta ao SF padrão ao reiniciar
+    n->adr_power_dbm = 0;
+    n->adr_sent = 0;
+    n->adr_report = 0;
+    node_link_reset(n);
+    n->last_seq = header->seq;
+    n->seq_window = 1;
+    return NODE_RX_FIRST;
+}
+
+node_rx_result_t node_table_update(const frame_header_t *header, uint64_t now_us, node_stats_t **node) {
+    node_rx_result_t result = node_table_account(header, true, node);
+
+    // Atrasado chegou fora de ordem: não entra nos intervalos
+    if (result == NODE_RX_LATE) {
+        (*node)->received++;
+    } else if (result == NODE_RX_OK || result == NODE_RX_FIRST) {
+        node_stats_arrival(*node, now_us);
+    }
+    return result;
+}
+
+node_rx_result_t node_table_recovered(const frame_header_t *header, node_stats_t **node) {
+    node_rx_result_t result = node_table_account(header, false, node);
+
+    if (result != NODE_RX_DUPLICATE && result != NODE_RX_TABLE_FULL) {
+        (*node)->recovered++;
+    }
+    return result;
+}
+
+bool node_sample_accept(node_stats_t *node, uint16_t sample_seq) {
+    if (!node->have_samples) {
+        node->have_samples = true;
+        node->sample_high = sample_seq;
+        node->sample_window = 1;
+        node->samples++;
+        return true;
+    }
+
+    int16_t diff = (int16_t)(sample_seq - node->sample_high);
+    if (diff > 0) {
+        node->sample_window = diff >= 32 ? 0 : node->sample_window << diff;
+        node->sample_window |= 1;
+        node->sample_high = sample_seq;
+        node->samples++;
+        return true;
+    }
+
+    // Mais antiga que a janela: não há como saber, aceita
+    uint32_t back = (uint32_t)(-diff);
+    if (back >= 32) {
+        node->samples++;
+        return true;
+    }
+    if (node->sample_window & (1u << back)) {
+        node->sample_dups++;
+        return false;
+    }
+    node->sample_window |= 1u << back;
+    node->samples++;
+    return true;
+}
+
+void node_sample_ack(const node_stats_t *node, uint16_t *base_seq, uint16_t *bitmap) {
+    *base_seq = node->sample_high;
+    *bitmap = node->have_samples ? (uint16_t)node->sample_window : 0;
+}
+
+void node_link_update(node_stats_t *node, int snr_db, int rssi_dbm) {
+    node->snr_db = (int8_t)snr_db;
+    node->rssi_dbm = (int16_t)rssi_dbm;
+    node->snr_history[node->snr_next] = (int8_t)snr_db;
+    node->snr_next = (uint8_t)((node->snr_next + 1) % NODE_LINK_HISTORY);
+    if (node->snr_count < NODE_LINK_HISTORY) node->snr_count++;
+}
+
+int node_link_snr_max(const node_stats_t *node) {
+    int max = INT8_MIN;
+    for (uint8_t i = 0; i < node->snr_count; i++) {
+        if (node->snr_history[i] > max) max = node->snr_history[i];
+    }
+    return max;
+}
+
+void node_link_reset(node_stats_t *node) {
+    node->snr_count = 0;
+    node->snr_next = 0;
+}
+
+uint32_t node_stats_loss_permille(const node_stats_t *node) {
+    uint32_t expected = node->received + node->recovered + node->lost;
+    if (expected == 0) return 0;
+    return (uint32_t)(((uint64_t)node->lost * 1000 + expected / 2) / expected);
+}
+
+void node_stats_print(const node_stats_t *node) {
+    uint32_t loss = node_stats_loss_permille(node);
+    uint32_t mean_ms = node->interval_count ? (uint32_t)(node->interval_sum_us / node->interval_count / 1000) : 0;
+
+    printf("[NO %3u] seq=%u rx=%lu recuperados=%lu perdidos=%lu (%lu.%lu%%) dup=%lu reinicios=%lu "
+           "intervalo=%lu ms (min %lu, max %lu) jitter=%lu ms",
+           node->node_id, node->last_seq,
+           (unsigned long)node->received, (unsigned long)node->recovered, (unsigned long)node->lost,
+           (unsigned long)(loss / 10), (unsigned long)(loss % 10),
+           (unsigned long)node->duplicates, (unsigned long)node->resets,
+           (unsigned long)mean_ms,
+           (unsigned long)(node->interval_min_us / 1000), (unsigned long)(node->interval_max_us / 1000),
+           (unsigned long)(node->jitter_us / 1000));
+    if (node->snr_count > 0) {
+        printf(" snr=%d dB rssi=%d dBm", node->snr_db, node->rssi_dbm);
+    }
+    if (node->adr_report) {
+        printf(" SF%u %d dBm", FRAME_ADR_SF(node->adr_report), FRAME_ADR_POWER_DBM(node->adr_report));
+    }
+    if (node->implicit_ok) {
+        printf(" implicito");
+    }
+    if (node->have_samples) {
+        printf(" amostras=%lu (ate %u) reenviadas=%lu",
+               (unsigned long)node->samples, node->sample_high, (unsigned long)node->sample_dups);
+    }
+    if (node->bulk_samples) {
+        printf(" log=%lu", (unsigned long)node->bulk_samples);
+    }
+    printf("\n");
+}
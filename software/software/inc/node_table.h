@@ -0,0 +1,148 @@
+// node_table.h
+
+#ifndef NODE_TABLE_H_
+#define NODE_TABLE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lora_frame.h"
+
+// Nós acompanhados ao mesmo tempo; quadros de nós além disso são ignorados
+#define NODE_TABLE_SIZE 32
+
+// Quadros com seq até esta distância para trás do último aceito são
+// duplicatas ou atrasados (recuperados pela paridade); mais longe que isso
+// o nó reiniciou sem o quadro de FRAME_FLAG_RESET ter chegado. Máximo 31.
+#define NODE_DUP_WINDOW 16
+
+// Quadros no histórico de SNR de cada nó (máximo usado pelo ADR)
+#define NODE_LINK_HISTORY 8
+
+// Resultado de node_table_update()
+typedef enum {
+    NODE_RX_OK,        // Quadro novo, na sequência ou após uma lacuna
+    NODE_RX_FIRST,     // Primeiro quadro do nó (ou após ele reiniciar)
+    NODE_RX_LATE,      // Anterior ao último, mas ainda não recebido (perda desfeita)
+    NODE_RX_DUPLICATE, // Já recebido: descartar
+    NODE_RX_TABLE_FULL // Nó desconhecido e tabela cheia: descartar
+} node_rx_result_t;
+
+// Estado e contadores de um transmissor
+typedef struct {
+    uint8_t node_id;
+    bool in_use;
+    uint16_t last_seq;     // Último seq aceito
+    uint32_t seq_window;   // Bit i: quadro last_seq - i aceito
+    uint32_t received;     // Quadros aceitos pelo rádio
+    uint32_t recovered;    // Quadros perdidos no ar e reconstruídos pela paridade
+    uint32_t lost;         // Quadros que faltaram na sequência
+    uint32_t duplicates;   // Quadros repetidos descartados
+    uint32_t resets;       // Reinícios do nó (seq recomeçou)
+    uint64_t last_rx_us;   // Chegada do último quadro aceito
+
+    // Intervalo entre chegadas de quadros aceitos, em us
+    uint32_t interval_count;
+    uint64_t interval_sum_us;
+    uint32_t interval_min_us;
+    uint32_t interval_max_us;
+    uint32_t last_interval_us;
+    uint32_t jitter_us;    // Média móvel (1/16) da variação entre intervalos
+
+    // Amostras com seq próprio (quadros em lote do ARQ)
+    bool have_samples;
+    uint16_t sample_high;    // Amostra mais nova recebida
+    uint32_t sample_window;  // Bit i: amostra sample_high - i recebida
+    uint32_t samples;        // Amostras novas
+    uint32_t sample_dups;    // Amostras reenviadas que já tinham chegado (ACK perdido)
+    uint32_t bulk_samples;   // Leituras recebidas em despejos do log (FSK)
+
+    // Enlace: SNR dos últimos quadros, recomeçado a cada mudança de taxa
+    int8_t snr_history[NODE_LINK_HISTORY];
+    uint8_t snr_count;       // Quadros no histórico
+    uint8_t snr_next;        // Próxima posição a sobrescrever
+    int8_t snr_db;           // Último SNR
+    int16_t rssi_dbm;        // Último RSSI
+
+    // Taxa e potência comandadas pelo ADR (0: padrão, ainda sem comando)
+    uint8_t adr_sf;
+    int8_t adr_power_dbm;
+    uint8_t adr_sent;        // Último comando nos ACKs (FRAME_ADR()); 0: nenhum
+    uint8_t adr_report;      // Em uso, relatado pelo nó nos lotes (FRAME_ADR()); 0: sem relato
+
+    // Último quadro de sensor anunciou FRAME_FLAG_IMPLICIT
+    bool implicit_ok;
+} node_stats_t;
+
+/**
+ * @brief Apaga todos os nós.
+ */
+void node_table_reset(void);
+
+/**
+ * @brief Contabiliza um quadro recebido: sequência, perdas, duplicatas e
+ * intervalo de chegada.
+ * @param header Cabeçalho do quadro.
+ * @param now_us Instante da recepção (time_us_64()).
+ * @param node Recebe o estado do nó (NULL com NODE_RX_TABLE_FULL).
+ * @return Classificação do quadro.
+ */
+node_rx_result_t node_table_update(const frame_header_t *header, uint64_t now_us, node_stats_t **node);
+
+/**
+ * @brief Contabiliza um quadro reconstruído pela paridade (fec_rx): deixa de
+ * contar como perdido, sem entrar nos intervalos de chegada.
+ * @return NODE_RX_LATE (ou NODE_RX_OK se é o mais novo do nó), ou
+ * NODE_RX_DUPLICATE se o quadro já tinha chegado.
+ */
+node_rx_result_t node_table_recovered(const frame_header_t *header, node_stats_t **node);
+
+/**
+ * @brief Registra uma amostra de um quadro em lote.
+ * @return true se é nova; false se já tinha chegado antes.
+ */
+bool node_sample_accept(node_stats_t *node, uint16_t sample_seq);
+
+/**
+ * @brief Monta o ACK seletivo: as 16 amostras mais recentes recebidas.
+ */
+void node_sample_ack(const node_stats_t *node, uint16_t *base_seq, uint16_t *bitmap);
+
+/**
+ * @brief Registra SNR e RSSI de um quadro do nó.
+ */
+void node_link_update(node_stats_t *node, int snr_db, int rssi_dbm);
+
+/**
+ * @brief Maior SNR do histórico; o pior caso é decidido pela margem do ADR.
+ */
+int node_link_snr_max(const node_stats_t *node);
+
+/**
+ * @brief Esquece o histórico de SNR (após uma mudança de taxa).
+ */
+void node_link_reset(node_stats_t *node);
+
+/**
+ * @brief Acesso por posição, para percorrer a tabela.
+ * @return O nó na posição index, ou NULL se a posição está livre.
+ */
+node_stats_t *node_table_at(int index);
+
+/**
+ * @brief Procura um nó pela identificação.
+ * @return O estado do nó ou NULL se ele nunca foi ouvido.
+ */
+node_stats_t *node_table_find(uint8_t node_id);
+
+/**
+ * @brief Perda em décimos de por cento (quadros perdidos / esperados),
+ * depois da recuperação pela paridade.
+ */
+uint32_t node_stats_loss_permille(const node_stats_t *node);
+
+/**
+ * @brief Imprime uma linha com os contadores do nó.
+ */
+void node_stats_print(const node_stats_t *node);
+
+#endif // NODE_TABLE_H_
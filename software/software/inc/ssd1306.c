@@ -3,16 +3,91 @@
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
+#ifdef SSD1306_HOST
+#include "ssd1306_host.h"
+#else
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
-#include "math.h"
+#endif
+
+#ifdef SSD1306_USE_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#endif
+
+#ifdef SSD1306_USE_INTERP
+#include "hardware/interp.h"
+#endif
+
+#ifdef SSD1306_USE_PIO
+#include "hardware/pio.h"
+#include "ssd1306_i2c.pio.h"
+#endif
 
 #if defined(SSD1306_USE_I2C)
 
 const uint8_t I2C_SDA_PIN = 14;
 const uint8_t I2C_SCL_PIN = 15;
 
+// Largest payload sent per transaction by ssd1306_WriteData()
+#define SSD1306_DATA_CHUNK 32
+
+#ifdef SSD1306_USE_PIO
+// Bus word of ssd1306_i2c.pio: START/STOP flags above the inverted byte
+#define SSD1306_BUS_START    (1u << 15)
+#define SSD1306_BUS_STOP     (1u << 14)
+#define SSD1306_BUS_WORD(b)  ((uint16_t)(uint8_t)~(b))
+
+static int SSD1306_PioSm = -1;
+#else
+// Bus word of the I2C block: IC_DATA_CMD, the address is taken from IC_TAR
+#define SSD1306_BUS_STOP     I2C_IC_DATA_CMD_STOP_BITS
+#define SSD1306_BUS_WORD(b)  ((uint16_t)(b))
+#endif
+
+static void ssd1306_BusInit(void)
+{
+#if defined(SSD1306_HOST)
+    // The emulator needs no setup
+#elif defined(SSD1306_USE_PIO)
+    // The hardware I2C block stays free for other devices
+    if (SSD1306_PioSm < 0)
+    {
+        SSD1306_PioSm = pio_claim_unused_sm(SSD1306_PIO, true);
+        uint offset = pio_add_program(SSD1306_PIO, &ssd1306_i2c_program);
+        ssd1306_i2c_program_init(SSD1306_PIO, SSD1306_PioSm, offset, I2C_SDA_PIN, I2C_SCL_PIN, SSD1306_I2C_CLK * 1000);
+    }
+#else
+    // I2C is "open drain", pull ups to keep signal high when no data is being
+    // sent
+    i2c_init(SSD1306_I2C_PORT, SSD1306_I2C_CLK * 1000);
+    gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(I2C_SDA_PIN);
+    gpio_pull_up(I2C_SCL_PIN);
+#endif
+}
+
+// One blocking write transaction to the panel. Returns false on a NAK.
+static bool ssd1306_BusWrite(const uint8_t *buf, size_t len)
+{
+#if defined(SSD1306_USE_PIO)
+    pio_sm_put_blocking(SSD1306_PIO, SSD1306_PioSm,
+                        (uint32_t)(SSD1306_BUS_START | SSD1306_BUS_WORD(SSD1306_I2C_ADDR << 1)) << 16);
+    for (size_t i = 0; i < len; i++)
+    {
+        uint32_t word = SSD1306_BUS_WORD(buf[i]) | ((i == len - 1) ? SSD1306_BUS_STOP : 0);
+        pio_sm_put_blocking(SSD1306_PIO, SSD1306_PioSm, word << 16);
+    }
+    return pio_sm_get_blocking(SSD1306_PIO, SSD1306_PioSm) == 0;
+#elif defined(SSD1306_HOST)
+    return ssd1306_HostWrite(buf, len);
+#else
+    return i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, buf, len, false) == (int)len;
+#endif
+}
+
 void ssd1306_Reset(void)
 {
     /* for I2C - do nothing */
@@ -21,33 +96,317 @@ void ssd1306_Reset(void)
 // Send a byte to the command register
 void ssd1306_WriteCommand(uint8_t byte)
 {
+#ifdef SSD1306_USE_DMA
+    ssd1306_WaitForUpdate();
+#endif
+
     uint8_t buffer[2]; // Buffer contendo o registrador e o dado
     buffer[0] = 0x00;  // Endereço do registrador
     buffer[1] = byte;  // Dado a ser enviado
 
-    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, buffer, sizeof(buffer), false);
+    ssd1306_BusWrite(buffer, sizeof(buffer));
+}
+
+// Send several commands in one transaction. 'stream' starts with the 0x00
+// control byte, followed by the command bytes.
+static void ssd1306_WriteCommandStream(const uint8_t *stream, size_t len)
+{
+#ifdef SSD1306_USE_DMA
+    ssd1306_WaitForUpdate();
+#endif
+
+    ssd1306_BusWrite(stream, len);
 }
 
 // Send data
 void ssd1306_WriteData(uint8_t *buffer, size_t buff_size)
 {
-    uint8_t temp_buffer[buff_size + 1];         // Buffer temporário
-    temp_buffer[0] = 0x40;                      // Endereço do registrador (Control byte)
-    memcpy(&temp_buffer[1], buffer, buff_size); // Copia os dados para o buffer temporário
+    // Generic path for arbitrary buffers: the control byte is prepended in
+    // bounded chunks. The screenbuffer never goes through here, see
+    // ssd1306_UpdateScreen().
+    uint8_t chunk[1 + SSD1306_DATA_CHUNK];
+    chunk[0] = 0x40; // Control byte: data stream
+
+#ifdef SSD1306_USE_DMA
+    ssd1306_WaitForUpdate();
+#endif
 
-    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, temp_buffer, sizeof(temp_buffer), false);
+    while (buff_size > 0)
+    {
+        size_t len = (buff_size < SSD1306_DATA_CHUNK) ? buff_size : SSD1306_DATA_CHUNK;
+        memcpy(&chunk[1], buffer, len);
+        ssd1306_BusWrite(chunk, len + 1);
+        buffer += len;
+        buff_size -= len;
+    }
 }
 
 #else
 #error "You should define SSD1306_USE_SPI or SSD1306_USE_I2C macro"
 #endif
 
-// Screenbuffer
-static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE];
+// Screenbuffer. It is stored right after the 0x40 data control byte, so the
+// whole frame is flushed as one I2C transaction without a copy.
+static uint8_t SSD1306_Frame[1 + SSD1306_BUFFER_SIZE] = {0x40};
+static uint8_t *const SSD1306_Buffer = &SSD1306_Frame[1];
+
+// Column/page window covering the whole screen, sent before each flush
+#define SSD1306_X_START ((SSD1306_X_OFFSET_UPPER << 4) | SSD1306_X_OFFSET_LOWER)
+static const uint8_t SSD1306_WindowCmd[] = {
+    0x00,                                                       // Control byte: command stream
+    0x21, SSD1306_X_START, SSD1306_X_START + SSD1306_WIDTH - 1, // Set column address
+    0x22, 0, SSD1306_PAGES - 1                                  // Set page address
+};
 
 // Screen object
 static SSD1306_t SSD1306;
 
+#ifdef SSD1306_CONTENT_SCROLL
+// One column content scroll command, without control byte
+#define SSD1306_SCROLL_CMD_LEN 7
+
+static void ssd1306_ScrollColumnCmd(uint8_t cmd[SSD1306_SCROLL_CMD_LEN], SSD1306_SCROLL_DIR dir,
+                                    uint8_t start_page, uint8_t end_page, uint8_t x1, uint8_t x2)
+{
+    cmd[0] = (dir == SSD1306_SCROLL_LEFT) ? 0x2D : 0x2C; // One column content scroll
+    cmd[1] = 0x00;                                       // Dummy byte
+    cmd[2] = start_page;
+    cmd[3] = 0x01;                                       // Dummy byte
+    cmd[4] = end_page;
+    cmd[5] = SSD1306_X_START + x1;
+    cmd[6] = SSD1306_X_START + x2;
+}
+#else
+#define SSD1306_SCROLL_CMD_LEN 0
+#endif
+
+#ifdef SSD1306_USE_DMA
+// Transactions per asynchronous update: window commands, then the frame
+#define SSD1306_TX_TRANSACTIONS 2
+
+#ifdef SSD1306_USE_PIO
+#define SSD1306_TX_ADDR_WORDS SSD1306_TX_TRANSACTIONS // START + address word each
+#else
+#define SSD1306_TX_ADDR_WORDS 0
+#endif
+
+// Front buffer. DMA feeds the bus TX FIFO with 16-bit bus words, so the
+// window commands (after a content scroll, for chart windows) and the frame
+// are expanded here, each ending with a STOP.
+static uint16_t SSD1306_TxStream[SSD1306_TX_ADDR_WORDS + SSD1306_SCROLL_CMD_LEN + sizeof(SSD1306_WindowCmd) +
+                                 sizeof(SSD1306_Frame)];
+static int SSD1306_DmaChannel = -1;
+static SSD1306_UpdateCallback_t SSD1306_UpdateCallback = NULL;
+#ifdef SSD1306_USE_PIO
+static uint8_t SSD1306_PioPending = 0; // Statuses of the last update still to read
+#endif
+
+// Expand one transaction into bus words, returns the next free word
+static uint16_t *ssd1306_StreamTransaction(uint16_t *out, const uint8_t *bytes, size_t len)
+{
+#ifdef SSD1306_USE_PIO
+    *out++ = SSD1306_BUS_START | SSD1306_BUS_WORD(SSD1306_I2C_ADDR << 1);
+#endif
+    for (size_t i = 0; i < len; i++)
+    {
+        *out++ = SSD1306_BUS_WORD(bytes[i]);
+    }
+    out[-1] |= SSD1306_BUS_STOP;
+    return out;
+}
+
+static void ssd1306_DmaIrqHandler(void)
+{
+    if (dma_channel_get_irq0_status(SSD1306_DmaChannel))
+    {
+        dma_channel_acknowledge_irq0(SSD1306_DmaChannel);
+        if (SSD1306_UpdateCallback)
+        {
+            SSD1306_UpdateCallback();
+        }
+    }
+}
+
+static void ssd1306_DmaInit(void)
+{
+    SSD1306_DmaChannel = dma_claim_unused_channel(true);
+    dma_channel_config cfg = dma_channel_get_default_config(SSD1306_DmaChannel);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+#ifdef SSD1306_USE_PIO
+    // A 16-bit write is replicated to both halves of the FIFO word
+    channel_config_set_dreq(&cfg, pio_get_dreq(SSD1306_PIO, SSD1306_PioSm, true));
+    volatile void *fifo = &SSD1306_PIO->txf[SSD1306_PioSm];
+#else
+    channel_config_set_dreq(&cfg, i2c_get_dreq(SSD1306_I2C_PORT, true));
+    volatile void *fifo = &i2c_get_hw(SSD1306_I2C_PORT)->data_cmd;
+#endif
+    dma_channel_configure(SSD1306_DmaChannel, &cfg, fifo, SSD1306_TxStream,
+                          sizeof(SSD1306_TxStream) / sizeof(SSD1306_TxStream[0]), false);
+
+    dma_channel_set_irq0_enabled(SSD1306_DmaChannel, true);
+    irq_add_shared_handler(DMA_IRQ_0, ssd1306_DmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+// Claim the front buffer for a new update, false while one is on the bus
+static bool ssd1306_AsyncBegin(void)
+{
+    if (ssd1306_UpdateScreenBusy())
+    {
+        return false;
+    }
+
+#ifdef SSD1306_USE_PIO
+    // Collect the statuses of the previous update
+    ssd1306_WaitForUpdate();
+    SSD1306_PioPending = SSD1306_TX_TRANSACTIONS;
+#else
+    i2c_hw_t *hw = i2c_get_hw(SSD1306_I2C_PORT);
+    if (hw->tar != SSD1306_I2C_ADDR)
+    {
+        // The target can only change while the bus is idle
+        ssd1306_WaitForUpdate();
+        hw->enable = 0;
+        hw->tar = SSD1306_I2C_ADDR;
+        hw->enable = 1;
+    }
+#endif
+    return true;
+}
+
+// Send the front buffer up to `end`
+static void ssd1306_AsyncStart(const uint16_t *end)
+{
+    dma_channel_transfer_from_buffer_now(SSD1306_DmaChannel, SSD1306_TxStream, (uint32_t)(end - SSD1306_TxStream));
+}
+
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void)
+{
+    if (!ssd1306_AsyncBegin())
+    {
+        return SSD1306_ERR;
+    }
+
+    // Swap: copy the back buffer into the front buffer
+    uint16_t *out = SSD1306_TxStream;
+    out = ssd1306_StreamTransaction(out, SSD1306_WindowCmd, sizeof(SSD1306_WindowCmd));
+    out = ssd1306_StreamTransaction(out, SSD1306_Frame, sizeof(SSD1306_Frame));
+    ssd1306_AsyncStart(out);
+    return SSD1306_OK;
+}
+
+// Commands (`prefix`, then the column/page window) and the window's part
+// of the screenbuffer, as one DMA update
+static SSD1306_Error_t ssd1306_WindowAsync(const uint8_t *prefix, size_t prefix_len,
+                                           uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2)
+{
+    if ((x1 > x2) || (page1 > page2) || (x2 >= SSD1306_WIDTH) || (page2 >= SSD1306_PAGES) ||
+        !ssd1306_AsyncBegin())
+    {
+        return SSD1306_ERR;
+    }
+
+    uint8_t cmd[1 + SSD1306_SCROLL_CMD_LEN + 6];
+    size_t len = 0;
+    cmd[len++] = 0x00; // Control byte: command stream
+    for (size_t i = 0; i < prefix_len; i++)
+    {
+        cmd[len++] = prefix[i];
+    }
+    cmd[len++] = 0x21; // Set column address
+    cmd[len++] = SSD1306_X_START + x1;
+    cmd[len++] = SSD1306_X_START + x2;
+    cmd[len++] = 0x22; // Set page address
+    cmd[len++] = page1;
+    cmd[len++] = page2;
+
+    uint16_t *out = ssd1306_StreamTransaction(SSD1306_TxStream, cmd, len);
+
+    // The window rows go out back to back in a single data transaction
+#ifdef SSD1306_USE_PIO
+    *out++ = SSD1306_BUS_START | SSD1306_BUS_WORD(SSD1306_I2C_ADDR << 1);
+#endif
+    *out++ = SSD1306_BUS_WORD(0x40); // Control byte: data stream
+    for (uint8_t page = page1; page <= page2; page++)
+    {
+        for (uint8_t x = x1; x <= x2; x++)
+        {
+            *out++ = SSD1306_BUS_WORD(SSD1306_Buffer[x + page * SSD1306_WIDTH]);
+        }
+    }
+    out[-1] |= SSD1306_BUS_STOP;
+
+    ssd1306_AsyncStart(out);
+    return SSD1306_OK;
+}
+
+SSD1306_Error_t ssd1306_UpdateWindowAsync(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2)
+{
+    return ssd1306_WindowAsync(NULL, 0, x1, x2, page1, page2);
+}
+
+#ifdef SSD1306_CONTENT_SCROLL
+SSD1306_Error_t ssd1306_ScrollColumnAsync(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1,
+                                          uint8_t x2)
+{
+    if ((x1 >= x2) || (start_page > end_page))
+    {
+        return SSD1306_ERR;
+    }
+
+    uint8_t scroll[SSD1306_SCROLL_CMD_LEN];
+    ssd1306_ScrollColumnCmd(scroll, dir, start_page, end_page, x1, x2);
+    // The column that entered the window follows the scroll
+    const uint8_t x = (dir == SSD1306_SCROLL_LEFT) ? x2 : x1;
+    return ssd1306_WindowAsync(scroll, sizeof(scroll), x, x, start_page, end_page);
+}
+#endif
+
+uint8_t ssd1306_UpdateScreenBusy(void)
+{
+    return (SSD1306_DmaChannel >= 0) && dma_channel_is_busy(SSD1306_DmaChannel);
+}
+
+void ssd1306_WaitForUpdate(void)
+{
+    if (SSD1306_DmaChannel < 0)
+    {
+        return;
+    }
+
+    // DMA done only means the last byte is in the TX FIFO, wait for the STOP
+    dma_channel_wait_for_finish_blocking(SSD1306_DmaChannel);
+#ifdef SSD1306_USE_PIO
+    // The state machine pushes one status word per STOP
+    while (SSD1306_PioPending)
+    {
+        (void)pio_sm_get_blocking(SSD1306_PIO, SSD1306_PioSm);
+        SSD1306_PioPending--;
+    }
+#else
+    i2c_hw_t *hw = i2c_get_hw(SSD1306_I2C_PORT);
+    while (!(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS))
+    {
+        tight_loop_contents();
+    }
+
+    // A NACK during the transfer leaves the FIFO flushed until the abort is
+    // cleared, which would fail the next blocking write
+    if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    {
+        (void)hw->clr_tx_abrt;
+    }
+#endif
+}
+
+void ssd1306_SetUpdateCallback(SSD1306_UpdateCallback_t callback)
+{
+    SSD1306_UpdateCallback = callback;
+}
+#endif
+
 /* Fills the Screenbuffer with values from a given buffer of a fixed length */
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t *buf, uint32_t len)
 {
@@ -60,103 +419,141 @@ SSD1306_Error_t ssd1306_FillBuffer(uint8_t *buf, uint32_t len)
     return ret;
 }
 
-/* Initialize the oled screen */
-void ssd1306_Init(void)
-{
-    // Reset OLED
-    ssd1306_Reset();
-
-    // Wait for the screen to boot
-    sleep_ms(100);
-
-    // I2C is "open drain", pull ups to keep signal high when no data is being
-    // sent
-    i2c_init(i2c1, SSD1306_I2C_CLK * 1000);
-    gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA_PIN);
-    gpio_pull_up(I2C_SCL_PIN);
+/*
+ * Init command stream, sent as a single I2C transaction. The first byte is
+ * the 0x00 control byte: everything after it is interpreted as commands.
+ */
+static const uint8_t SSD1306_InitCmd[] = {
+    0x00, // Control byte: command stream
 
-    // Init OLED
-    ssd1306_SetDisplayOn(0); // display off
+    0xAE, // Display off
 
-    ssd1306_WriteCommand(0x20); // Set Memory Addressing Mode
-    ssd1306_WriteCommand(0x00); // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
-                                // 10b,Page Addressing Mode (RESET); 11b,Invalid
+    0x20, // Set Memory Addressing Mode
+    0x00, // 00b,Horizontal Addressing Mode; 01b,Vertical Addressing Mode;
+          // 10b,Page Addressing Mode (RESET); 11b,Invalid
 
-    ssd1306_WriteCommand(0xB0); // Set Page Start Address for Page Addressing Mode,0-7
+    0xB0, // Set Page Start Address for Page Addressing Mode,0-7
 
 #ifdef SSD1306_MIRROR_VERT
-    ssd1306_WriteCommand(0xC0); // Mirror vertically
+    0xC0, // Mirror vertically
 #else
-    ssd1306_WriteCommand(0xC8); // Set COM Output Scan Direction
+    0xC8, // Set COM Output Scan Direction
 #endif
 
-    ssd1306_WriteCommand(0x00); //---set low column address
-    ssd1306_WriteCommand(0x10); //---set high column address
+    0x00, //---set low column address
+    0x10, //---set high column address
 
-    ssd1306_WriteCommand(0x40); //--set start line address - CHECK
+    0x40, //--set start line address - CHECK
 
-    ssd1306_SetContrast(0xFF);
+    0x81, // Set contrast control register
+    0xFF,
 
 #ifdef SSD1306_MIRROR_HORIZ
-    ssd1306_WriteCommand(0xA0); // Mirror horizontally
+    0xA0, // Mirror horizontally
 #else
-    ssd1306_WriteCommand(0xA1); //--set segment re-map 0 to 127 - CHECK
+    0xA1, //--set segment re-map 0 to 127 - CHECK
 #endif
 
 #ifdef SSD1306_INVERSE_COLOR
-    ssd1306_WriteCommand(0xA7); //--set inverse color
+    0xA7, //--set inverse color
 #else
-    ssd1306_WriteCommand(0xA6); //--set normal color
+    0xA6, //--set normal color
 #endif
 
 // Set multiplex ratio.
 #if (SSD1306_HEIGHT == 128)
     // Found in the Luma Python lib for SH1106.
-    ssd1306_WriteCommand(0xFF);
+    0xFF,
 #else
-    ssd1306_WriteCommand(0xA8); //--set multiplex ratio(1 to 64) - CHECK
+    0xA8, //--set multiplex ratio(1 to 64) - CHECK
 #endif
 
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x1F); //
+    0x1F, //
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x3F); //
+    0x3F, //
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x3F); // Seems to work for 128px high displays too.
+    0x3F, // Seems to work for 128px high displays too.
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
 
-    ssd1306_WriteCommand(0xA4); // 0xa4,Output follows RAM content;0xa5,Output ignores RAM content
+    0xA4, // 0xa4,Output follows RAM content;0xa5,Output ignores RAM content
 
-    ssd1306_WriteCommand(0xD3); //-set display offset - CHECK
-    ssd1306_WriteCommand(0x00); //-not offset
+    0xD3, //-set display offset - CHECK
+    0x00, //-not offset
 
-    ssd1306_WriteCommand(0xD5); //--set display clock divide ratio/oscillator frequency
-    ssd1306_WriteCommand(0xF0); //--set divide ratio
+    0xD5, //--set display clock divide ratio/oscillator frequency
+    0xF0, //--set divide ratio
 
-    ssd1306_WriteCommand(0xD9); //--set pre-charge period
-    ssd1306_WriteCommand(0x22); //
+    0xD9, //--set pre-charge period
+    0x22, //
 
-    ssd1306_WriteCommand(0xDA); //--set com pins hardware configuration - CHECK
+    0xDA, //--set com pins hardware configuration - CHECK
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x02);
+    0x02,
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
 
-    ssd1306_WriteCommand(0xDB); //--set vcomh
-    ssd1306_WriteCommand(0x20); // 0x20,0.77xVcc
+    0xDB, //--set vcomh
+    0x20, // 0x20,0.77xVcc
+
+    0x8D, //--set DC-DC enable
+    0x14, //
+
+    0xAF, //--turn on SSD1306 panel
+};
+
+// Longest wait for the controller to acknowledge its address after power-up
+#define SSD1306_BOOT_TIMEOUT_MS 100
+
+/*
+ * Wait until the controller acknowledges a NOP command (0xE3) instead of
+ * sleeping for a fixed time. Gives up after SSD1306_BOOT_TIMEOUT_MS, like
+ * the fixed delay it replaces.
+ */
+static void ssd1306_WaitReady(void)
+{
+    static const uint8_t nop[] = {0x00, 0xE3};
+    absolute_time_t deadline = make_timeout_time_ms(SSD1306_BOOT_TIMEOUT_MS);
+
+    while (!ssd1306_BusWrite(nop, sizeof(nop)))
+    {
+        if (time_reached(deadline))
+        {
+            return;
+        }
+        sleep_us(500);
+    }
+}
+
+/* Initialize the oled screen */
+void ssd1306_Init(void)
+{
+    // Reset OLED
+    ssd1306_Reset();
+
+    ssd1306_BusInit();
+
+#ifdef SSD1306_USE_DMA
+    if (SSD1306_DmaChannel < 0)
+    {
+        ssd1306_DmaInit();
+    }
+    ssd1306_WaitForUpdate();
+#endif
+
+    // Wait for the screen to boot
+    ssd1306_WaitReady();
 
-    ssd1306_WriteCommand(0x8D); //--set DC-DC enable
-    ssd1306_WriteCommand(0x14); //
-    ssd1306_SetDisplayOn(1);    //--turn on SSD1306 panel
+    // Init OLED
+    ssd1306_WriteCommandStream(SSD1306_InitCmd, sizeof(SSD1306_InitCmd));
+    SSD1306.DisplayOn = 1;
 
     // Clear screen
     ssd1306_Fill(Black);
@@ -174,24 +571,55 @@ void ssd1306_Init(void)
 /* Fill the whole screen with the given color */
 void ssd1306_Fill(SSD1306_COLOR color)
 {
-    memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer));
+    memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, SSD1306_BUFFER_SIZE);
 }
 
 /* Write the screenbuffer with changed to the screen */
 void ssd1306_UpdateScreen(void)
 {
-    // Write data to each page of RAM. Number of pages
-    // depends on the screen height:
-    //
-    //  * 32px   ==  4 pages
-    //  * 64px   ==  8 pages
-    //  * 128px  ==  16 pages
-    for (uint8_t i = 0; i < SSD1306_HEIGHT / 8; i++)
+    // Horizontal addressing mode is enabled in ssd1306_Init(), so once the
+    // column/page window spans the whole screen the RAM pointer wraps from
+    // page to page by itself. The frame then goes out in one transaction:
+    // control byte + SSD1306_BUFFER_SIZE bytes of screenbuffer.
+    ssd1306_WriteCommandStream(SSD1306_WindowCmd, sizeof(SSD1306_WindowCmd));
+    ssd1306_BusWrite(SSD1306_Frame, sizeof(SSD1306_Frame));
+}
+
+/* Write a part of the screenbuffer: columns x1..x2 of pages page1..page2 */
+void ssd1306_UpdateWindow(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2)
+{
+    if ((x1 > x2) || (page1 > page2) || (x2 >= SSD1306_WIDTH) || (page2 >= SSD1306_PAGES))
+    {
+        return;
+    }
+
+    const uint8_t window[] = {
+        0x00,                                             // Control byte: command stream
+        0x21, SSD1306_X_START + x1, SSD1306_X_START + x2, // Set column address
+        0x22, page1, page2                                // Set page address
+    };
+    ssd1306_WriteCommandStream(window, sizeof(window));
+
+    // The RAM pointer walks the window row by row, so the rows are gathered
+    // into as few data transactions as possible
+    uint8_t chunk[1 + SSD1306_DATA_CHUNK];
+    size_t len = 0;
+    chunk[0] = 0x40; // Control byte: data stream
+    for (uint8_t page = page1; page <= page2; page++)
     {
-        ssd1306_WriteCommand(0xB0 + i); // Set the current RAM page address.
-        ssd1306_WriteCommand(0x00 + SSD1306_X_OFFSET_LOWER);
-        ssd1306_WriteCommand(0x10 + SSD1306_X_OFFSET_UPPER);
-        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH * i], SSD1306_WIDTH);
+        for (uint8_t x = x1; x <= x2; x++)
+        {
+            chunk[1 + len++] = SSD1306_Buffer[x + page * SSD1306_WIDTH];
+            if (len == SSD1306_DATA_CHUNK)
+            {
+                ssd1306_BusWrite(chunk, len + 1);
+                len = 0;
+            }
+        }
+    }
+    if (len)
+    {
+        ssd1306_BusWrite(chunk, len + 1);
     }
 }
 
@@ -220,7 +648,84 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color)
     }
 }
 
+/*
+ * Fill the area between two corners (inclusive), clipped to the screen.
+ * Works on whole page bytes: the top and bottom pages are merged through
+ * precomputed masks, the pages in between are plain memsets.
+ */
+static void ssd1306_FillArea(int32_t x1, int32_t y1, int32_t x2, int32_t y2, SSD1306_COLOR color)
+{
+    int32_t x_start = ((x1 <= x2) ? x1 : x2);
+    int32_t x_end = ((x1 <= x2) ? x2 : x1);
+    int32_t y_start = ((y1 <= y2) ? y1 : y2);
+    int32_t y_end = ((y1 <= y2) ? y2 : y1);
+
+    if (x_end < 0 || y_end < 0 || x_start >= SSD1306_WIDTH || y_start >= SSD1306_HEIGHT)
+    {
+        return;
+    }
+    x_start = (x_start < 0) ? 0 : x_start;
+    y_start = (y_start < 0) ? 0 : y_start;
+    x_end = (x_end >= SSD1306_WIDTH) ? SSD1306_WIDTH - 1 : x_end;
+    y_end = (y_end >= SSD1306_HEIGHT) ? SSD1306_HEIGHT - 1 : y_end;
+
+    const size_t len = x_end - x_start + 1;
+    const uint8_t mask_top = 0xFF << (y_start % 8);
+    const uint8_t mask_bottom = 0xFF >> (7 - (y_end % 8));
+    uint8_t *dst = &SSD1306_Buffer[x_start + (y_start / 8) * SSD1306_WIDTH];
+
+    for (int32_t page = y_start / 8; page <= y_end / 8; page++, dst += SSD1306_WIDTH)
+    {
+        uint8_t mask = 0xFF;
+        if (page == y_start / 8)
+        {
+            mask &= mask_top;
+        }
+        if (page == y_end / 8)
+        {
+            mask &= mask_bottom;
+        }
+
+        if (mask == 0xFF)
+        {
+            memset(dst, (color == White) ? 0xFF : 0x00, len);
+        }
+        else if (color == White)
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                dst[i] |= mask;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < len; i++)
+            {
+                dst[i] &= ~mask;
+            }
+        }
+    }
+}
+
+/* Draw a horizontal line */
+void ssd1306_DrawHLine(uint8_t x1, uint8_t x2, uint8_t y, SSD1306_COLOR color)
+{
+    ssd1306_FillArea(x1, y, x2, y, color);
+}
+
+/* Draw a vertical line */
+void ssd1306_DrawVLine(uint8_t x, uint8_t y1, uint8_t y2, SSD1306_COLOR color)
+{
+    ssd1306_FillArea(x, y1, x, y2, color);
+}
+
 void ssd1306_DrawLineCustom(int x0, int y0, int x1, int y1, SSD1306_COLOR color) {
+    if (x0 == x1 || y0 == y1) {
+        ssd1306_FillArea(x0, y0, x1, y1, color);
+        return;
+    }
+
+
     int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
     int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1; 
     int err = dx + dy, e2;
@@ -234,6 +739,163 @@ void ssd1306_DrawLineCustom(int x0, int y0, int x1, int y1, SSD1306_COLOR color)
     }
 }
 
+/*
+ * Draw a glyph stored in page/column layout (see tools/font_pages.py).
+ * Each glyph byte holds 8 vertical pixels; it is shifted by y % 8 and
+ * merged into the two framebuffer pages it straddles, so the whole cell
+ * (glyph in color, background in !color) is written a byte at a time.
+ * The caller guarantees the cell is inside the screen.
+ */
+static void ssd1306_BlitGlyph(const uint8_t *glyph, uint8_t w, uint8_t h, uint8_t x, uint8_t y, SSD1306_COLOR color)
+{
+    const uint8_t shift = y % 8;
+    const uint8_t invert = (color == White) ? 0x00 : 0xFF;
+    uint8_t *dst = &SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH];
+
+    for (uint8_t row = 0; row < h; row += 8, glyph += w, dst += SSD1306_WIDTH)
+    {
+        // Rows of the cell covered by this glyph page (the last one may be partial)
+        const uint8_t mask = (h - row >= 8) ? 0xFF : (uint8_t)((1 << (h - row)) - 1);
+        const uint8_t mask_lo = (uint8_t)(mask << shift);
+        const uint8_t mask_hi = (uint8_t)((mask << shift) >> 8);
+
+        for (uint8_t i = 0; i < w; i++)
+        {
+            const uint16_t bits = (uint16_t)((glyph[i] ^ invert) & mask) << shift;
+            dst[i] = (dst[i] & ~mask_lo) | (uint8_t)bits;
+            if (mask_hi)
+            {
+                dst[i + SSD1306_WIDTH] = (dst[i + SSD1306_WIDTH] & ~mask_hi) | (uint8_t)(bits >> 8);
+            }
+        }
+    }
+}
+
+#ifdef SSD1306_USE_INTERP
+/*
+ * Program interp0 to walk a row-major bitmap: ACCUM0 is the byte offset of
+ * the current row and gains the pitch on every POP, ACCUM1 is the column
+ * and is kept (ADD_RAW with BASE1 = 0) while contributing column / 8 to the
+ * FULL result. POP2 then reads as bitmap + row * pitch + column / 8 and
+ * steps to the next row. Drawing only runs from the main loop, so interp0
+ * is not shared with interrupt handlers.
+ */
+static void ssd1306_InterpSetup(const uint8_t *bitmap, uint32_t pitch)
+{
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_set_config(interp0, 0, &cfg);
+
+    cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, 3);
+    interp_set_config(interp0, 1, &cfg);
+
+    interp0->base[0] = pitch;
+    interp0->base[1] = 0;
+    interp0->base[2] = (uintptr_t)bitmap;
+}
+#endif
+
+/*
+ * Draw a row-major, MSB-first bitmap (pitch bytes per row) by gathering 8
+ * source rows of a column into one page byte and merging it like
+ * ssd1306_BlitGlyph(). Transparent blits only touch the set pixels, opaque
+ * ones also paint the background in !color. Clipped to the screen; x and y
+ * must be on it.
+ */
+static void ssd1306_BlitBits(const uint8_t *bitmap, uint32_t pitch, uint8_t w, uint8_t h,
+                             uint8_t x, uint8_t y, SSD1306_COLOR color, bool opaque)
+{
+    const uint8_t shift = y % 8;
+    const uint8_t invert = (color == White) ? 0x00 : 0xFF;
+    uint8_t *dst = &SSD1306_Buffer[x + (y / 8) * SSD1306_WIDTH];
+
+    if (w > SSD1306_WIDTH - x)
+        w = SSD1306_WIDTH - x;
+    if (h > SSD1306_HEIGHT - y)
+        h = SSD1306_HEIGHT - y;
+
+#ifdef SSD1306_USE_INTERP
+    ssd1306_InterpSetup(bitmap, pitch);
+#endif
+
+    for (uint8_t row = 0; row < h; row += 8, dst += SSD1306_WIDTH)
+    {
+        const uint8_t rows = (h - row >= 8) ? 8 : h - row;
+        const uint8_t mask = (uint8_t)((1 << rows) - 1);
+        const uint8_t mask_hi = (uint8_t)((mask << shift) >> 8);
+
+        for (uint8_t i = 0; i < w; i++)
+        {
+            const uint8_t bit = 0x80 >> (i & 7);
+            uint8_t bits = 0;
+
+#ifdef SSD1306_USE_INTERP
+            interp0->accum[0] = row * pitch;
+            interp0->accum[1] = i;
+            for (uint8_t k = 0; k < rows; k++)
+            {
+                if (*(const uint8_t *)interp0->pop[2] & bit)
+                    bits |= 1 << k;
+            }
+#else
+            const uint8_t *src = &bitmap[row * pitch + i / 8];
+            for (uint8_t k = 0; k < rows; k++, src += pitch)
+            {
+                if (*src & bit)
+                    bits |= 1 << k;
+            }
+#endif
+
+            // Pixels to set and to clear in the column, shifted onto the pages
+            uint16_t set, clear;
+            if (opaque)
+            {
+                set = (uint16_t)((bits ^ invert) & mask) << shift;
+                clear = (uint16_t)mask << shift;
+            }
+            else
+            {
+                set = (color == White) ? (uint16_t)bits << shift : 0;
+                clear = (uint16_t)bits << shift;
+            }
+
+            dst[i] = (dst[i] & ~(uint8_t)clear) | (uint8_t)set;
+            if (mask_hi)
+            {
+                dst[i + SSD1306_WIDTH] = (dst[i + SSD1306_WIDTH] & ~(uint8_t)(clear >> 8)) | (uint8_t)(set >> 8);
+            }
+        }
+    }
+}
+
+/*
+ * Expand one PackBits compressed glyph (tools/font_pages.py --rle): a
+ * header n >= 0 is followed by n + 1 literal bytes, n < 0 by one byte
+ * repeated 1 - n times.
+ */
+static void ssd1306_UnpackGlyph(const uint8_t *src, uint8_t *dst, uint32_t len)
+{
+    uint8_t *const end = dst + len;
+
+    while (dst < end)
+    {
+        int32_t n = (int8_t)*src++;
+        if (n >= 0)
+        {
+            memcpy(dst, src, n + 1);
+            src += n + 1;
+            dst += n + 1;
+        }
+        else
+        {
+            memset(dst, *src++, 1 - n);
+            dst += 1 - n;
+        }
+    }
+}
+
 /*
  * Draw 1 char to the screen buffer
  * ch       => char om weg te schrijven
@@ -242,8 +904,6 @@ void ssd1306_DrawLineCustom(int x0, int y0, int x1, int y1, SSD1306_COLOR color)
  */
 char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color)
 {
-    uint32_t i, b, j;
-
     // Check if character is valid
     if (ch < 32 || ch > 126)
         return 0;
@@ -256,20 +916,44 @@ char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color)
         return 0;
     }
 
-    // Use the font to write
-    for (i = 0; i < Font.height; i++)
+    if (Font.pages)
     {
-        b = Font.data[(ch - 32) * Font.height + i];
-        for (j = 0; j < Font.width; j++)
+        const uint32_t glyph_size = ((Font.height + 7) / 8) * Font.width;
+        uint32_t index = ch - 32;
+        const uint8_t *glyph;
+        uint8_t unpacked[SSD1306_GLYPH_MAX_BYTES];
+
+        // Subsetted fonts only carry the characters the firmware prints
+        if (Font.glyph_map)
         {
-            if ((b << j) & 0x8000)
-            {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)color);
-            }
-            else
-            {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)!color);
-            }
+            index = Font.glyph_map[index];
+            if (index == SSD1306_GLYPH_NONE)
+                return 0;
+        }
+
+        if (Font.rle_offsets)
+        {
+            ssd1306_UnpackGlyph(&Font.pages[Font.rle_offsets[index]], unpacked, glyph_size);
+            glyph = unpacked;
+        }
+        else
+        {
+            glyph = &Font.pages[index * glyph_size];
+        }
+
+        ssd1306_BlitGlyph(glyph, Font.width, Font.height, SSD1306.CurrentX, SSD1306.CurrentY, color);
+    }
+    else
+    {
+        // Rows are MSB-first uint16_t: on the little-endian RP2040 columns
+        // 0-7 are in the second byte of each row and 8-15 in the first
+        const uint8_t *rows = (const uint8_t *)&Font.data[(ch - 32) * Font.height];
+        ssd1306_BlitBits(rows + 1, 2, Font.width < 8 ? Font.width : 8, Font.height,
+                         SSD1306.CurrentX, SSD1306.CurrentY, color, true);
+        if (Font.width > 8)
+        {
+            ssd1306_BlitBits(rows, 2, Font.width - 8, Font.height,
+                             SSD1306.CurrentX + 8, SSD1306.CurrentY, color, true);
         }
     }
 
@@ -314,6 +998,12 @@ void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR
     int32_t error = deltaX - deltaY;
     int32_t error2;
 
+    if ((x1 == x2) || (y1 == y2))
+    {
+        ssd1306_FillArea(x1, y1, x2, y2, color);
+        return;
+    }
+
     ssd1306_DrawPixel(x2, y2, color);
 
     while ((x1 != x2) || (y1 != y2))
@@ -352,10 +1042,59 @@ void ssd1306_Polyline(const SSD1306_VERTEX *par_vertex, uint16_t par_size, SSD13
     return;
 }
 
-/* Convert Degrees to Radians */
-static float ssd1306_DegToRad(float par_deg)
+/*
+ * Quarter-wave sine table, one entry per degree in Q14 (16384 == 1.0).
+ * The entries are constant expressions (Taylor series up to x^9, error
+ * below 1e-5), folded by the compiler: no floating point at run time.
+ */
+#define SSD1306_TRIG_ONE   16384
+#define SSD1306_ANGLE_FRAC 64 // Sub-degree angle resolution (1/64 degree)
+
+#define SSD1306_RAD(d)      ((d) * 3.14159265358979 / 180.0)
+#define SSD1306_SIN_POLY(r) ((r) * (1 - (r) * (r) / 6 * (1 - (r) * (r) / 20 * (1 - (r) * (r) / 42 * (1 - (r) * (r) / 72)))))
+#define SSD1306_SIN_Q14(d)  ((int16_t)(SSD1306_SIN_POLY(SSD1306_RAD(d)) * SSD1306_TRIG_ONE + 0.5))
+#define SSD1306_SIN_ROW(d)                                                    \
+    SSD1306_SIN_Q14(d), SSD1306_SIN_Q14(d + 1), SSD1306_SIN_Q14(d + 2),       \
+    SSD1306_SIN_Q14(d + 3), SSD1306_SIN_Q14(d + 4), SSD1306_SIN_Q14(d + 5),   \
+    SSD1306_SIN_Q14(d + 6), SSD1306_SIN_Q14(d + 7), SSD1306_SIN_Q14(d + 8),   \
+    SSD1306_SIN_Q14(d + 9)
+
+static const int16_t SSD1306_SinTable[91] = {
+    SSD1306_SIN_ROW(0), SSD1306_SIN_ROW(10), SSD1306_SIN_ROW(20),
+    SSD1306_SIN_ROW(30), SSD1306_SIN_ROW(40), SSD1306_SIN_ROW(50),
+    SSD1306_SIN_ROW(60), SSD1306_SIN_ROW(70), SSD1306_SIN_ROW(80),
+    SSD1306_SIN_Q14(90)
+};
+
+/* Sine in Q14 of an angle given in 1/SSD1306_ANGLE_FRAC degree */
+static int32_t ssd1306_Sin(uint32_t angle)
 {
-    return par_deg * (3.14f / 180.0f);
+    angle %= 360 * SSD1306_ANGLE_FRAC;
+    const int32_t sign = (angle >= 180 * SSD1306_ANGLE_FRAC) ? -1 : 1;
+    if (sign < 0)
+    {
+        angle -= 180 * SSD1306_ANGLE_FRAC;
+    }
+    if (angle > 90 * SSD1306_ANGLE_FRAC)
+    {
+        angle = 180 * SSD1306_ANGLE_FRAC - angle;
+    }
+
+    // Linear interpolation between the two surrounding degrees
+    const uint32_t deg = angle / SSD1306_ANGLE_FRAC;
+    const int32_t frac = angle % SSD1306_ANGLE_FRAC;
+    int32_t value = SSD1306_SinTable[deg];
+    if (frac)
+    {
+        value += ((SSD1306_SinTable[deg + 1] - value) * frac) / SSD1306_ANGLE_FRAC;
+    }
+    return sign * value;
+}
+
+/* Cosine in Q14 of an angle given in 1/SSD1306_ANGLE_FRAC degree */
+static int32_t ssd1306_Cos(uint32_t angle)
+{
+    return ssd1306_Sin(angle + 90 * SSD1306_ANGLE_FRAC);
 }
 
 /* Normalize degree to [0;360] */
@@ -374,6 +1113,19 @@ static uint16_t ssd1306_NormalizeTo0_360(uint16_t par_deg)
     return loc_angle;
 }
 
+/* Angle of arc segment 'count' in 1/SSD1306_ANGLE_FRAC degree */
+static uint32_t ssd1306_ArcAngle(uint32_t count, uint32_t sweep, uint32_t segments)
+{
+    return segments ? (count * sweep * SSD1306_ANGLE_FRAC) / segments : 0;
+}
+
+/* Point of the circle (x, y, radius) at the given angle */
+static void ssd1306_ArcPoint(uint8_t x, uint8_t y, uint8_t radius, uint32_t angle, uint8_t *px, uint8_t *py)
+{
+    *px = x + (int8_t)((ssd1306_Sin(angle) * radius) / SSD1306_TRIG_ONE);
+    *py = y + (int8_t)((ssd1306_Cos(angle) * radius) / SSD1306_TRIG_ONE);
+}
+
 /*
  * DrawArc. Draw angle is beginning from 4 quart of trigonometric circle (3pi/2)
  * start_angle in degree
@@ -382,35 +1134,21 @@ static uint16_t ssd1306_NormalizeTo0_360(uint16_t par_deg)
 void ssd1306_DrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color)
 {
     static const uint8_t CIRCLE_APPROXIMATION_SEGMENTS = 36;
-    float approx_degree;
     uint32_t approx_segments;
     uint8_t xp1, xp2;
     uint8_t yp1, yp2;
     uint32_t count;
     uint32_t loc_sweep;
-    float rad;
 
     loc_sweep = ssd1306_NormalizeTo0_360(sweep);
 
     count = (ssd1306_NormalizeTo0_360(start_angle) * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
     approx_segments = (loc_sweep * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
-    approx_degree = loc_sweep / (float)approx_segments;
     while (count < approx_segments)
     {
-        rad = ssd1306_DegToRad(count * approx_degree);
-        xp1 = x + (int8_t)(sinf(rad) * radius);
-        yp1 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_ArcPoint(x, y, radius, ssd1306_ArcAngle(count, loc_sweep, approx_segments), &xp1, &yp1);
         count++;
-        if (count != approx_segments)
-        {
-            rad = ssd1306_DegToRad(count * approx_degree);
-        }
-        else
-        {
-            rad = ssd1306_DegToRad(loc_sweep);
-        }
-        xp2 = x + (int8_t)(sinf(rad) * radius);
-        yp2 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_ArcPoint(x, y, radius, ssd1306_ArcAngle(count, loc_sweep, approx_segments), &xp2, &yp2);
         ssd1306_Line(xp1, yp1, xp2, yp2, color);
     }
 
@@ -426,7 +1164,6 @@ void ssd1306_DrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle,
 void ssd1306_DrawArcWithRadiusLine(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color)
 {
     const uint32_t CIRCLE_APPROXIMATION_SEGMENTS = 36;
-    float approx_degree;
     uint32_t approx_segments;
     uint8_t xp1;
     uint8_t xp2 = 0;
@@ -434,33 +1171,20 @@ void ssd1306_DrawArcWithRadiusLine(uint8_t x, uint8_t y, uint8_t radius, uint16_
     uint8_t yp2 = 0;
     uint32_t count;
     uint32_t loc_sweep;
-    float rad;
+    uint8_t first_point_x;
+    uint8_t first_point_y;
 
     loc_sweep = ssd1306_NormalizeTo0_360(sweep);
 
     count = (ssd1306_NormalizeTo0_360(start_angle) * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
     approx_segments = (loc_sweep * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
-    approx_degree = loc_sweep / (float)approx_segments;
 
-    rad = ssd1306_DegToRad(count * approx_degree);
-    uint8_t first_point_x = x + (int8_t)(sinf(rad) * radius);
-    uint8_t first_point_y = y + (int8_t)(cosf(rad) * radius);
+    ssd1306_ArcPoint(x, y, radius, ssd1306_ArcAngle(count, loc_sweep, approx_segments), &first_point_x, &first_point_y);
     while (count < approx_segments)
     {
-        rad = ssd1306_DegToRad(count * approx_degree);
-        xp1 = x + (int8_t)(sinf(rad) * radius);
-        yp1 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_ArcPoint(x, y, radius, ssd1306_ArcAngle(count, loc_sweep, approx_segments), &xp1, &yp1);
         count++;
-        if (count != approx_segments)
-        {
-            rad = ssd1306_DegToRad(count * approx_degree);
-        }
-        else
-        {
-            rad = ssd1306_DegToRad(loc_sweep);
-        }
-        xp2 = x + (int8_t)(sinf(rad) * radius);
-        yp2 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_ArcPoint(x, y, radius, ssd1306_ArcAngle(count, loc_sweep, approx_segments), &xp2, &yp2);
         ssd1306_Line(xp1, yp1, xp2, yp2, color);
     }
 
@@ -524,15 +1248,12 @@ void ssd1306_FillCircle(uint8_t par_x, uint8_t par_y, uint8_t par_r, SSD1306_COL
         return;
     }
 
+    // y visits every row offset 0..r while |x| only shrinks, so the first
+    // span drawn at each offset is the widest one
     do
     {
-        for (uint8_t _y = (par_y + y); _y >= (par_y - y); _y--)
-        {
-            for (uint8_t _x = (par_x - x); _x >= (par_x + x); _x--)
-            {
-                ssd1306_DrawPixel(_x, _y, par_color);
-            }
-        }
+        ssd1306_FillArea(par_x + x, par_y + y, par_x - x, par_y + y, par_color);
+        ssd1306_FillArea(par_x + x, par_y - y, par_x - x, par_y - y, par_color);
 
         e2 = err;
         if (e2 <= y)
@@ -558,10 +1279,10 @@ void ssd1306_FillCircle(uint8_t par_x, uint8_t par_y, uint8_t par_r, SSD1306_COL
 /* Draw a rectangle */
 void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color)
 {
-    ssd1306_Line(x1, y1, x2, y1, color);
-    ssd1306_Line(x2, y1, x2, y2, color);
-    ssd1306_Line(x2, y2, x1, y2, color);
-    ssd1306_Line(x1, y2, x1, y1, color);
+    ssd1306_FillArea(x1, y1, x2, y1, color);
+    ssd1306_FillArea(x2, y1, x2, y2, color);
+    ssd1306_FillArea(x1, y2, x2, y2, color);
+    ssd1306_FillArea(x1, y1, x1, y2, color);
 
     return;
 }
@@ -569,18 +1290,7 @@ void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD13
 /* Draw a filled rectangle */
 void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color)
 {
-    uint8_t x_start = ((x1 <= x2) ? x1 : x2);
-    uint8_t x_end = ((x1 <= x2) ? x2 : x1);
-    uint8_t y_start = ((y1 <= y2) ? y1 : y2);
-    uint8_t y_end = ((y1 <= y2) ? y2 : y1);
-
-    for (uint8_t y = y_start; (y <= y_end) && (y < SSD1306_HEIGHT); y++)
-    {
-        for (uint8_t x = x_start; (x <= x_end) && (x < SSD1306_WIDTH); x++)
-        {
-            ssd1306_DrawPixel(x, y, color);
-        }
-    }
+    ssd1306_FillArea(x1, y1, x2, y2, color);
     return;
 }
 
@@ -626,36 +1336,80 @@ SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint
 /* Draw a bitmap */
 void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char *bitmap, uint8_t w, uint8_t h, SSD1306_COLOR color)
 {
-    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-    uint8_t byte = 0;
-
     if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT)
     {
         return;
     }
 
-    for (uint8_t j = 0; j < h; j++, y++)
+    // Bitmap scanline pad = whole byte
+    ssd1306_BlitBits(bitmap, (w + 7) / 8, w, h, x, y, color, false);
+}
+
+void ssd1306_ScrollHorizontal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t interval)
+{
+    const uint8_t cmd[] = {
+        0x00,             // Control byte: command stream
+        0x2E,             // Deactivate scroll before changing its setup
+        (uint8_t)dir,     // Right (0x26) or left (0x27) horizontal scroll
+        0x00,             // Dummy byte
+        start_page & 0x07,
+        interval & 0x07,  // Time interval between each scroll step, in frames
+        end_page & 0x07,
+        0x00, 0xFF,       // Dummy bytes
+        0x2F              // Activate scroll
+    };
+    ssd1306_WriteCommandStream(cmd, sizeof(cmd));
+}
+
+void ssd1306_ScrollStop(void)
+{
+    // RAM content must be rewritten after a continuous scroll is stopped
+    static const uint8_t cmd[] = {0x00, 0x2E};
+    ssd1306_WriteCommandStream(cmd, sizeof(cmd));
+}
+
+void ssd1306_ScrollBuffer(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1, uint8_t x2)
+{
+    if ((x1 >= x2) || (start_page > end_page) || (x2 >= SSD1306_WIDTH) || (end_page >= SSD1306_PAGES))
+    {
+        return;
+    }
+
+    // Rotate each page row by one column, like the controller does
+    for (uint8_t page = start_page; page <= end_page; page++)
     {
-        for (uint8_t i = 0; i < w; i++)
+        uint8_t *row = &SSD1306_Buffer[page * SSD1306_WIDTH];
+        uint8_t wrap;
+        if (dir == SSD1306_SCROLL_LEFT)
         {
-            if (i & 7)
-            {
-                byte <<= 1;
-            }
-            else
-            {
-                byte = (*(const unsigned char *)(&bitmap[j * byteWidth + i / 8]));
-            }
-
-            if (byte & 0x80)
-            {
-                ssd1306_DrawPixel(x + i, y, color);
-            }
+            wrap = row[x1];
+            memmove(&row[x1], &row[x1 + 1], x2 - x1);
+            row[x2] = wrap;
+        }
+        else
+        {
+            wrap = row[x2];
+            memmove(&row[x1 + 1], &row[x1], x2 - x1);
+            row[x1] = wrap;
         }
     }
-    return;
 }
 
+#ifdef SSD1306_CONTENT_SCROLL
+void ssd1306_ScrollColumn(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1, uint8_t x2)
+{
+    if ((x1 >= x2) || (start_page > end_page) || (x2 >= SSD1306_WIDTH) || (end_page >= SSD1306_PAGES))
+    {
+        return;
+    }
+
+    uint8_t cmd[1 + SSD1306_SCROLL_CMD_LEN];
+    cmd[0] = 0x00; // Control byte: command stream
+    ssd1306_ScrollColumnCmd(&cmd[1], dir, start_page, end_page, x1, x2);
+    ssd1306_WriteCommandStream(cmd, sizeof(cmd));
+}
+#endif
+
 void ssd1306_SetContrast(const uint8_t value)
 {
     const uint8_t kSetContrastControlRegister = 0x81;
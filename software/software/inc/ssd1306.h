@@ -3,13 +3,26 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#ifdef SSD1306_HOST
+// newlib's C linkage wrappers, missing from the host libc
+#define _BEGIN_STD_C
+#define _END_STD_C
+#else
 #include <_ansi.h>
+#endif
 
 _BEGIN_STD_C
 
 #include "ssd1306_conf.h"
 
+// I2C bus clock in kHz. Standard/Fast-mode (100/400) and Fast-mode Plus (1000).
+#ifndef SSD1306_I2C_CLK
 #define SSD1306_I2C_CLK 400
+#endif
+
+#if (SSD1306_I2C_CLK > 1000)
+#error "SSD1306_I2C_CLK above 1000 kHz (Fast-mode Plus) is not supported"
+#endif
 
 #ifdef SSD1306_X_OFFSET
 #define SSD1306_X_OFFSET_LOWER (SSD1306_X_OFFSET & 0x0F)
@@ -29,6 +42,11 @@ _BEGIN_STD_C
 #define SSD1306_I2C_ADDR        0x3C
 #endif
 
+// PIO block running the bus with SSD1306_USE_PIO
+#ifndef SSD1306_PIO
+#define SSD1306_PIO             pio0
+#endif
+
 /* ^^^ I2C config ^^^ */
 
 // SSD1306 OLED height in pixels
@@ -45,12 +63,26 @@ _BEGIN_STD_C
 #define SSD1306_BUFFER_SIZE   SSD1306_WIDTH * SSD1306_HEIGHT / 8
 #endif
 
+// Number of 8px RAM pages
+#define SSD1306_PAGES           (SSD1306_HEIGHT / 8)
+
+// Largest page-layout glyph that may be RLE compressed (16x26 = 64 bytes)
+#define SSD1306_GLYPH_MAX_BYTES 64
+// glyph_map entry of a character left out of a subsetted font
+#define SSD1306_GLYPH_NONE      0xFF
+
 // Enumeration for screen colors
 typedef enum {
     Black = 0x00, // Black color, no pixel
     White = 0x01  // Pixel is set. Color depends on OLED
 } SSD1306_COLOR;
 
+// Horizontal scroll direction (command codes of the continuous scroll)
+typedef enum {
+    SSD1306_SCROLL_RIGHT = 0x26,
+    SSD1306_SCROLL_LEFT = 0x27
+} SSD1306_SCROLL_DIR;
+
 typedef enum {
     SSD1306_OK = 0x00,
     SSD1306_ERR = 0x01  // Generic error.
@@ -75,14 +107,81 @@ typedef struct {
 	const uint8_t height;               /**< Font height in pixels */
 	const uint16_t *const data;         /**< Pointer to font data array */
     const uint8_t *const char_width;    /**< Proportional character width in pixels (NULL for monospaced) */
+    const uint8_t *const pages;         /**< Glyphs in page/column layout, see tools/font_pages.py (NULL to rasterise data) */
+    const uint8_t *const glyph_map;     /**< Index into pages by ch - 32, SSD1306_GLYPH_NONE if absent (NULL: all 95 glyphs) */
+    const uint16_t *const rle_offsets;  /**< Start of each PackBits compressed glyph in pages (NULL: uncompressed) */
 } SSD1306_Font_t;
 
+/** Called when an asynchronous update has handed its last byte to the I2C FIFO */
+typedef void (*SSD1306_UpdateCallback_t)(void);
+
 // Procedure definitions
 void ssd1306_Init(void);
 void ssd1306_Fill(SSD1306_COLOR color);
 void ssd1306_UpdateScreen(void);
+
+/**
+ * @brief Write part of the screenbuffer to the screen.
+ * @param x1 First column
+ * @param x2 Last column (included)
+ * @param page1 First 8px page
+ * @param page2 Last 8px page (included)
+ */
+void ssd1306_UpdateWindow(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2);
+
+#ifdef SSD1306_USE_DMA
+/**
+ * @brief Send the screenbuffer through DMA and return immediately.
+ * 
+ * The screenbuffer (back buffer) is copied into the DMA front buffer before
+ * the transfer starts, so the next frame can be drawn right away.
+ * 
+ * @return SSD1306_ERR if the previous frame is still being transferred.
+ */
+SSD1306_Error_t ssd1306_UpdateScreenAsync(void);
+
+/**
+ * @brief Send columns x1..x2 of pages page1..page2 through DMA and return
+ * immediately, like ssd1306_UpdateScreenAsync().
+ * @return SSD1306_ERR if the previous update is still being transferred.
+ */
+SSD1306_Error_t ssd1306_UpdateWindowAsync(uint8_t x1, uint8_t x2, uint8_t page1, uint8_t page2);
+
+#ifdef SSD1306_CONTENT_SCROLL
+/**
+ * @brief ssd1306_ScrollColumn() followed by the column that entered the
+ * window, as one DMA update that returns immediately.
+ * @note Scroll the screenbuffer (ssd1306_ScrollBuffer()) and redraw the new
+ *       column first. Same parameters as ssd1306_ScrollColumn().
+ * @return SSD1306_ERR if the previous update is still being transferred.
+ */
+SSD1306_Error_t ssd1306_ScrollColumnAsync(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1,
+                                          uint8_t x2);
+#endif
+
+/**
+ * @brief Reads the asynchronous update state.
+ * @return  0: front buffer free, a new update can be started.
+ *          1: transfer in progress.
+ */
+uint8_t ssd1306_UpdateScreenBusy(void);
+
+/**
+ * @brief Blocks until the last asynchronous update is fully on the bus.
+ */
+void ssd1306_WaitForUpdate(void);
+
+/**
+ * @brief Sets the completion callback of asynchronous updates.
+ * @param[in] callback function to call, NULL to disable.
+ * @note Runs in DMA interrupt context.
+ */
+void ssd1306_SetUpdateCallback(SSD1306_UpdateCallback_t callback);
+#endif
 void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
 void ssd1306_DrawLineCustom(int x0, int y0, int x1, int y1, SSD1306_COLOR color);
+void ssd1306_DrawHLine(uint8_t x1, uint8_t x2, uint8_t y, SSD1306_COLOR color);
+void ssd1306_DrawVLine(uint8_t x, uint8_t y1, uint8_t y2, SSD1306_COLOR color);
 char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color);
 char ssd1306_WriteString(char* str, SSD1306_Font_t Font, SSD1306_COLOR color);
 void ssd1306_SetCursor(uint8_t x, uint8_t y);
@@ -108,6 +207,56 @@ SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint
 
 void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8_t w, uint8_t h, SSD1306_COLOR color);
 
+/**
+ * @brief Start a continuous horizontal scroll of the display RAM.
+ * @param dir Scroll direction.
+ * @param start_page First 8px page to scroll.
+ * @param end_page Last 8px page to scroll (included).
+ * @param interval Frames between scroll steps, 3-bit code (000b = 5 frames).
+ * @note Stop with ssd1306_ScrollStop() and redraw before writing to the screen.
+ */
+void ssd1306_ScrollHorizontal(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t interval);
+
+/**
+ * @brief Stop a continuous scroll.
+ */
+void ssd1306_ScrollStop(void);
+
+#ifdef SSD1306_CONTENT_SCROLL
+/**
+ * @brief Scroll a window of the display RAM by one column (one-shot content scroll).
+ * 
+ * Only the command is sent: scroll the screenbuffer the same way with
+ * ssd1306_ScrollBuffer(), then redraw and send with ssd1306_UpdateWindow()
+ * just the column that entered the window.
+ * Wait at least two frames between consecutive calls; to move several
+ * windows at once, scroll the range that covers them in one call.
+ *
+ * @note 0x2C/0x2D (content scroll) is not in the base SSD1306 command set.
+ *       It comes from later controller revisions (SSD1306B and successors);
+ *       on controllers without it the display RAM stays put while the
+ *       screenbuffer moves. Only built with SSD1306_CONTENT_SCROLL.
+ * 
+ * @param dir Scroll direction.
+ * @param start_page First 8px page
+ * @param end_page Last 8px page (included)
+ * @param x1 First column
+ * @param x2 Last column (included)
+ */
+void ssd1306_ScrollColumn(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1, uint8_t x2);
+#endif
+
+/**
+ * @brief Scroll a window of the screenbuffer only, by one column, the way
+ * the controller's content scroll does; send the window afterwards.
+ * @param dir Scroll direction.
+ * @param start_page First 8px page
+ * @param end_page Last 8px page (included)
+ * @param x1 First column
+ * @param x2 Last column (included)
+ */
+void ssd1306_ScrollBuffer(SSD1306_SCROLL_DIR dir, uint8_t start_page, uint8_t end_page, uint8_t x1, uint8_t x2);
+
 /**
  * @brief Sets the contrast of the display.
  * @param[in] value contrast to set.
@@ -14,6 +14,33 @@
 #define SSD1306_I2C_PORT        i2c1
 #define SSD1306_I2C_ADDR        0x3C //(0x3C << 1)
 
+// I2C clock in kHz: 100, 400 (Fast-mode) or 1000 (Fast-mode Plus).
+// 1000 kHz needs short wires and strong pull-ups (~1k) on SDA/SCL; go back
+// to 400 if the panel misses frames.
+#define SSD1306_I2C_CLK         1000
+
+// Pico-only backends, off in host builds against the emulator
+// (tools/ssd1306_host)
+#ifndef SSD1306_HOST
+
+// Drive the display bus from a PIO state machine (inc/ssd1306_i2c.pio)
+// instead of the I2C block, which is then left free for other devices.
+#define SSD1306_USE_PIO
+
+// Enable ssd1306_UpdateScreenAsync() (DMA fed I2C TX FIFO)
+#define SSD1306_USE_DMA
+
+// Let the SIO interpolator (interp0) generate the source addresses of
+// bitmap blits
+#define SSD1306_USE_INTERP
+
+#endif // SSD1306_HOST
+
+// One column content scroll (0x2C/0x2D, ssd1306_ScrollColumn()). Only
+// SSD1306B and later controllers have it; without it charts scroll in the
+// screenbuffer and their whole window is sent.
+// #define SSD1306_CONTENT_SCROLL
+
 // Mirror the screen if needed
 // #define SSD1306_MIRROR_VERT
 // #define SSD1306_MIRROR_HORIZ
@@ -21,11 +48,11 @@
 // Set inverse color if needed
 // # define SSD1306_INVERSE_COLOR
 
-// Include only needed fonts
-#define SSD1306_INCLUDE_FONT_6x8
-#define SSD1306_INCLUDE_FONT_7x10
-#define SSD1306_INCLUDE_FONT_11x18
-#define SSD1306_INCLUDE_FONT_16x26
+// Include only needed fonts (glyph subsets are chosen in CMakeLists.txt)
+// #define SSD1306_INCLUDE_FONT_6x8
+// #define SSD1306_INCLUDE_FONT_7x10
+// #define SSD1306_INCLUDE_FONT_11x18
+// #define SSD1306_INCLUDE_FONT_16x26
 
 #define SSD1306_INCLUDE_FONT_16x24
 
@@ -1,5 +1,4 @@
 #include <stdio.h>
-#include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ssd1306.h"
@@ -7,6 +6,13 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "lora_RFM95.h"
+#include "display_widgets.h"
+#include "lora_frame.h"
+#include "lora_channels.h"
+#include "node_table.h"
+#include "fec_rx.h"
+#include "adr.h"
+#include "bulk_rx.h"
 
 // ==========================================================
 // ===           CONFIGURAÇÕES E DEFINIÇÕES GLOBAIS        ===
@@ -21,31 +27,137 @@
 #define PIN_RST  20
 #define PIN_DIO0 8  // Pino de interrupção (necessário para LoRa)
 
-// Frequência de operação (em Hz)
-// Use a frequência correta para sua região:
-// - 915E6: América (US915)
-// - 868E6: Europa (EU868)
-// - 433E6: Ásia (AS433)
-#define LORA_FREQUENCY 915E6
+// Frequências: plano de canais em inc/lora_channels.h (igual ao dos nós).
+// O beacon fica sempre em LORA_BEACON_CHANNEL; os slots dos nós saltam
+// entre os TDMA_HOP_CHANNELS primeiros canais (1: sem saltos).
 
-// Intervalo entre envios (ms)
-#define SEND_INTERVAL_MS 10000 // 10 segundos
+// Superquadro TDMA: slot 0 para o beacon, os demais para os nós
+// (slot do nó = frame_tdma_slot()). Cada slot cabe o maior quadro entre
+// beacon e leitura mais a guarda; o superquadro deve ficar abaixo de ~60 s
+// (volta do timebase de 32 bits dos nós a 60 MHz).
+#define TDMA_SLOT_COUNT 8   // 7 nós; aumente para mais transmissores
+#define TDMA_GUARD_MS   100 // Folga para desvio de relógio e latência
+#define TDMA_LBT_BACKOFF_MS 20 // Primeira janela de backoff do LBT dos nós (LORA_LBT_BACKOFF_MS)
+#define TDMA_ARQ        1   // 1: slot comporta um lote cheio e o ACK (ARQ dos nós)
+#define TDMA_FEC        1   // 1: slot comporta um quadro de paridade (nós com FEC_K)
+#define TDMA_HOP_CHANNELS LORA_CHANNEL_COUNT
+#define TDMA_IMPLICIT_PROBE 8 // A cada N superquadros todos os slots voltam ao cabeçalho explícito
 
-// Estrutura do pacote recebido via LoRa
-typedef struct {
-    int16_t temperatura;
-    int16_t umidade;
-} sensor_packet_t;
+// Superquadros entre amostras pedidos aos nós, enviado de carona nos ACKs
+#define NODE_SAMPLE_INTERVAL 1
+
+// Limite de quadros por segundo enviados ao OLED. Pacotes que chegam mais
+// rápido que isso são agrupados: só o estado mais recente é desenhado.
+#define DISPLAY_MAX_FPS 10
+
+// Gráficos de tendência à direita dos valores: uma coluna por amostra
+#define CHART_X1        98
+#define CHART_X2        127
+#define CHART_TEMP_MIN  0      // 0.00 C
+#define CHART_TEMP_MAX  5000   // 50.00 C
+#define CHART_UMID_MIN  0      // 0.00 %
+#define CHART_UMID_MAX  10000  // 100.00 %
+
+// Com DISPLAY_BENCHMARK (cmake -DDISPLAY_BENCHMARK=ON) o boot mede a
+// velocidade do blit de bitmaps (ssd1306_DrawBitmap) contra o desenho pixel
+// a pixel antigo
+
+// Maior quadro LoRa (tamanho máximo do payload do SX127x)
+#define LORA_FRAME_MAX 255
 
 struct repeating_timer sync_timer;
 int sync_dot_index = 0;
+static bool sync_active = false;
+
+// Campos da tela de dados: guardam o último texto para redesenho incremental
+static value_widget_t temp_widget;
+static value_widget_t umid_widget;
+static trend_chart_t temp_chart;
+static trend_chart_t umid_chart;
+static bool sensor_screen_ready = false;
+
+// Estado mais recente a ser exibido, marcado como sujo a cada pacote
+static struct {
+    int16_t temperatura;
+    int16_t umidade;
+    bool dirty;
+} display_state;
+static absolute_time_t next_frame_time;
+static bool frame_pending = false; // framebuffer alterado e ainda não enviado
+
+// Agenda dos beacons
+static struct {
+    uint16_t superframe;        // seq do próximo beacon
+    uint16_t slot_ms;
+    absolute_time_t start;      // Início do superquadro atual
+    absolute_time_t next_beacon;
+    uint8_t channel;            // Canal sintonizado
+    uint8_t sf;                 // SF sintonizado
+    bool implicit;              // Cabeçalho implícito sintonizado
+    uint8_t slot_sf[TDMA_SLOT_COUNT]; // SF de cada slot no superquadro atual (ADR)
+    uint16_t implicit_slots;    // Bit s: slot s em cabeçalho implícito no superquadro atual
+    uint16_t implicit_granted;  // Slots liberados, sem as sondagens em explícito
+} tdma;
+
+// Beacon ou ACK no ar: o rádio está fora da recepção
+static bool radio_tx_active = false;
+
+// Despejo concedido no ACK em curso: começa quando ele sair do ar
+static struct {
+    uint8_t node_id;  // FRAME_NODE_GATEWAY: nenhum
+    uint64_t end_us;  // Fim do slot do nó
+} bulk_grant = { .node_id = FRAME_NODE_GATEWAY };
+
+// ==========================================================
+// ===              FILA DE EVENTOS DE INTERFACE           ===
+// ==========================================================
+// Interrupções (timers) apenas enfileiram eventos; todo desenho e I/O do
+// display acontecem em render_task(), no loop principal. Fila de um produtor
+// (interrupção) e um consumidor (loop), sem travas: cada índice tem um único
+// escritor.
+
+typedef enum {
+    UI_EVENT_SYNC_TICK, // Próximo passo da animação de sincronização
+} ui_event_t;
+
+#define UI_QUEUE_SIZE 8 // Potência de 2
+
+static volatile uint8_t ui_queue[UI_QUEUE_SIZE];
+static volatile uint8_t ui_queue_head = 0; // Escrito só pela interrupção
+static volatile uint8_t ui_queue_tail = 0; // Escrito só pelo loop principal
+
+// Seguro em interrupção. Descarta o evento se a fila estiver cheia.
+static bool ui_post(ui_event_t event) {
+    uint8_t head = ui_queue_head;
+    uint8_t next = (head + 1) & (UI_QUEUE_SIZE - 1);
+    if (next == ui_queue_tail) return false;
+    ui_queue[head] = (uint8_t)event;
+    __compiler_memory_barrier(); // Dado gravado antes de publicar o índice
+    ui_queue_head = next;
+    return true;
+}
+
+static bool ui_pop(ui_event_t *event) {
+    uint8_t tail = ui_queue_tail;
+    if (tail == ui_queue_head) return false;
+    *event = (ui_event_t)ui_queue[tail];
+    __compiler_memory_barrier();
+    ui_queue_tail = (tail + 1) & (UI_QUEUE_SIZE - 1);
+    return true;
+}
 
 // ==========================================================
 // ===                   FUNÇÕES DE DISPLAY               ===
 // ==========================================================
 
-// Callback usado pelo temporizador para exibir pontos animados
+// Callback do temporizador (contexto de interrupção): só posta o evento
 bool sync_screen_animation(struct repeating_timer *t) {
+    ui_post(UI_EVENT_SYNC_TICK);
+    return true;
+}
+
+// Desenha o próximo passo dos pontos animados (chamado por render_task)
+static void sync_animation_step(void) {
     if (sync_dot_index < 3) {
         ssd1306_SetCursor((sync_dot_index + 4) * 12, 6 + 15);
         ssd1306_WriteString(".", Font_16x15, White);
@@ -58,8 +170,6 @@ bool sync_screen_animation(struct repeating_timer *t) {
         sync_dot_index = -1;
     }
     sync_dot_index++;
-    ssd1306_UpdateScreen();
-    return true;
 }
 
 // Mostra tela de sincronização ("Sincronizando...")
@@ -69,31 +179,141 @@ void show_sync_screen() {
     ssd1306_WriteString("Sincronizando", Font_16x15, White);
     ssd1306_UpdateScreen();
 
-	ssd1306_SetCursor(0, 6);
+    // A animação segue no loop principal até o primeiro pacote chegar
+    sync_active = true;
     add_repeating_timer_ms(300, sync_screen_animation, NULL, &sync_timer);
-    sleep_ms(5000);
 }
 
-// Mostra dados de temperatura e umidade no display
-void show_sensor_data(float temperatura, float umidade) {
-    char temp_buf[10];
-    char umid_buf[10];
+// Encerra a tela de sincronização; eventos ainda na fila são ignorados
+void stop_sync_screen() {
+    cancel_repeating_timer(&sync_timer);
+    sync_active = false;
+}
 
-    sprintf(temp_buf, "%.1fC", temperatura);
-    sprintf(umid_buf, "%.1f%%", umidade);
+// Desenha dados de temperatura e umidade no framebuffer.
+// Valores chegam * 100; apenas os glifos que mudaram são redesenhados.
+// Retorna true se o quadro inteiro precisa ser enviado.
+bool show_sensor_data(int16_t temperatura, int16_t umidade) {
+    char temp_buf[VALUE_WIDGET_MAX_LEN + 1];
+    char umid_buf[VALUE_WIDGET_MAX_LEN + 1];
 
-    ssd1306_Fill(Black);
-    ssd1306_DrawLineCustom(0, 31, 127, 31, White);
+    format_fixed_x100(temperatura, "C", temp_buf);
+    format_fixed_x100(umidade, "%", umid_buf);
 
-    ssd1306_SetCursor(15, 5);
-    ssd1306_WriteString(temp_buf, Font_16x24, White);
+    if (!sensor_screen_ready) {
+        ssd1306_Fill(Black);
+        ssd1306_DrawLineCustom(0, 31, 127, 31, White);
+        value_widget_init(&temp_widget, 2, 5, &Font_16x24);
+        value_widget_init(&umid_widget, 2, 38, &Font_16x24);
+        trend_chart_init(&temp_chart, CHART_X1, CHART_X2, 0, 2, CHART_TEMP_MIN, CHART_TEMP_MAX);
+        trend_chart_init(&umid_chart, CHART_X1, CHART_X2, 5, 7, CHART_UMID_MIN, CHART_UMID_MAX);
+        sensor_screen_ready = true;
+    }
 
-    ssd1306_SetCursor(15, 38);
-    ssd1306_WriteString(umid_buf, Font_16x24, White);
+    bool changed = value_widget_draw(&temp_widget, temp_buf);
+    changed |= value_widget_draw(&umid_widget, umid_buf);
 
-    ssd1306_UpdateScreen();
+    // Se o texto mudou (ou já há quadro pendente) o quadro inteiro será
+    // enviado e os gráficos vão junto; senão só a janela dos gráficos sai,
+    // pelo DMA (com SSD1306_CONTENT_SCROLL, só a coluna nova). Os dois rolam
+    // juntos: entre eles só há a linha divisória
+    trend_chart_t *const charts[] = {&temp_chart, &umid_chart};
+    const int16_t values[] = {temperatura, umidade};
+    if (!trend_chart_push_group(charts, values, 2, !changed && !frame_pending)) {
+        changed = true; // DMA ocupado: a janela vai no próximo quadro inteiro
+    }
+    return changed;
 }
 
+// Registra uma nova leitura; o desenho fica para render_task()
+void display_post_sensor_data(int16_t temperatura, int16_t umidade) {
+    display_state.temperatura = temperatura;
+    display_state.umidade = umidade;
+    display_state.dirty = true;
+}
+
+// Agendador de renderização: aplica os eventos da fila, desenha o estado
+// mais recente e envia o quadro quando o limite de FPS permite e o quadro
+// anterior já saiu pelo DMA. Nunca bloqueia, então o rádio é atendido a
+// cada volta do loop principal. Único lugar que toca o framebuffer depois
+// da inicialização, o que evita quadros rasgados.
+void render_task(void) {
+    ui_event_t event;
+    while (ui_pop(&event)) {
+        switch (event) {
+        case UI_EVENT_SYNC_TICK:
+            if (sync_active) {
+                sync_animation_step();
+                frame_pending = true;
+            }
+            break;
+        }
+    }
+
+    if (!time_reached(next_frame_time)) return;
+    if (ssd1306_UpdateScreenBusy()) return;
+
+    if (display_state.dirty) {
+        display_state.dirty = false;
+        frame_pending |= show_sensor_data(display_state.temperatura, display_state.umidade);
+        // Mesmo sem quadro cheio a janela dos gráficos saiu pelo DMA: a próxima
+        // espera o intervalo de quadro (com rolagem pelo controlador, bem mais
+        // que os dois quadros do painel)
+        next_frame_time = make_timeout_time_ms(1000 / DISPLAY_MAX_FPS);
+    }
+
+    if (frame_pending && ssd1306_UpdateScreenAsync() == SSD1306_OK) {
+        // Envio via DMA: retorna imediatamente
+        frame_pending = false;
+        next_frame_time = make_timeout_time_ms(1000 / DISPLAY_MAX_FPS);
+    }
+}
+
+#ifdef DISPLAY_BENCHMARK
+// Implementação anterior de ssd1306_DrawBitmap(), usada só como referência
+static void draw_bitmap_per_pixel(uint8_t x, uint8_t y, const uint8_t *bitmap, uint8_t w, uint8_t h) {
+    const int byte_width = (w + 7) / 8;
+    uint8_t byte = 0;
+
+    for (uint8_t j = 0; j < h; j++, y++) {
+        for (uint8_t i = 0; i < w; i++) {
+            byte = (i & 7) ? byte << 1 : bitmap[j * byte_width + i / 8];
+            if (byte & 0x80) {
+                ssd1306_DrawPixel(x + i, y, White);
+            }
+        }
+    }
+}
+
+// Desenha um bitmap de tela cheia várias vezes e imprime pixels por us
+static void benchmark_blit(void) {
+    static uint8_t bitmap[SSD1306_WIDTH / 8 * SSD1306_HEIGHT];
+    const uint32_t runs = 100;
+    const uint32_t drawn = runs * SSD1306_WIDTH * (SSD1306_HEIGHT - 8);
+
+    for (size_t i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = (uint8_t)(i * 37 + 11); // padrão qualquer, não uniforme
+    }
+
+    uint64_t t0 = time_us_64();
+    for (uint32_t r = 0; r < runs; r++) {
+        draw_bitmap_per_pixel(0, r % 8, bitmap, SSD1306_WIDTH, SSD1306_HEIGHT - 8);
+    }
+    uint64_t t1 = time_us_64();
+    for (uint32_t r = 0; r < runs; r++) {
+        ssd1306_DrawBitmap(0, r % 8, bitmap, SSD1306_WIDTH, SSD1306_HEIGHT - 8, White);
+    }
+    uint64_t t2 = time_us_64();
+
+    // Décimos de pixel por us: sem printf de ponto flutuante no binário
+    const uint32_t blit = (uint32_t)(drawn * 10ull / (t2 - t1));
+    const uint32_t per_pixel = (uint32_t)(drawn * 10ull / (t1 - t0));
+    printf("[BENCH] DrawBitmap: %lu.%lu px/us (pixel a pixel: %lu.%lu px/us)\n",
+           (unsigned long)(blit / 10), (unsigned long)(blit % 10),
+           (unsigned long)(per_pixel / 10), (unsigned long)(per_pixel % 10));
+}
+#endif
+
 // ==========================================================
 // ===                FUNÇÕES DE INICIALIZAÇÃO             ===
 // ==========================================================
@@ -101,6 +321,8 @@ void show_sensor_data(float temperatura, float umidade) {
 // Inicializa o sistema LoRa e o display OLED
 void init_lora_system() {
     stdio_init_all();
+
+    uint64_t t_oled = time_us_64();
     ssd1306_Init();
 
     ssd1306_Fill(Black);
@@ -108,6 +330,15 @@ void init_lora_system() {
     ssd1306_WriteString("Iniciando LoRa", Font_16x15, White);
     ssd1306_UpdateScreen();
 
+    // Benchmark de boot: tempo desde o reset até o primeiro quadro no OLED
+    uint64_t t_frame = time_us_64();
+    printf("[BOOT] Primeiro quadro em %llu us (init OLED: %llu us)\n",
+           (unsigned long long)t_frame, (unsigned long long)(t_frame - t_oled));
+
+#ifdef DISPLAY_BENCHMARK
+    benchmark_blit();
+#endif
+
     lora_config_t lora_cfg = {
         .spi_instance = spi0,
         .pin_miso = PIN_MISO,
@@ -116,7 +347,7 @@ void init_lora_system() {
         .pin_mosi = PIN_MOSI,
         .pin_rst  = PIN_RST,
         .pin_dio0 = PIN_DIO0,
-        .frequency = LORA_FREQUENCY
+        .channel = LORA_BEACON_CHANNEL
     };
 
     if (!lora_init(lora_cfg)) {
@@ -136,32 +367,373 @@ void init_lora_system() {
     lora_start_rx_continuous();
 }
 
+// ==========================================================
+// ===                  ENVIO PELO GATEWAY                ===
+// ==========================================================
+
+// Inicia um envio sem bloquear; radio_task() devolve o rádio à recepção
+static bool radio_send_async(const void *frame, size_t len) {
+    if (radio_tx_active) return false;
+    radio_tx_active = lora_send_bytes_async((const uint8_t *)frame, len);
+    return radio_tx_active;
+}
+
+static void radio_task(void) {
+    if (radio_tx_active && !lora_tx_busy()) {
+        radio_tx_active = false;
+        if (bulk_grant.node_id != FRAME_NODE_GATEWAY) {
+            bulk_rx_start(bulk_grant.node_id, bulk_grant.end_us);
+            bulk_grant.node_id = FRAME_NODE_GATEWAY;
+        } else {
+            lora_start_rx_continuous();
+        }
+    }
+}
+
+// ==========================================================
+// ===                  BEACON TDMA                       ===
+// ==========================================================
+// O receptor é o relógio da rede: a cada superquadro envia um beacon com
+// seu instante e o tamanho dos slots, e os nós transmitem só no próprio
+// slot. Sem disputa pelo canal, a vazão cresce com o número de slots em
+// vez de colapsar com colisões.
+
+// Tamanho do slot a partir do tempo no ar dos quadros com a modulação atual
+static void tdma_init(void) {
+    uint32_t beacon_us = lora_time_on_air_us(FRAME_BEACON_LEN);
+    uint32_t sensor_us = lora_time_on_air_us(sizeof(frame_sensor_t));
+    uint32_t airtime_us = beacon_us > sensor_us ? beacon_us : sensor_us;
+
+#if TDMA_ARQ
+    // Lote cheio, espera do gateway e ACK
+    uint32_t arq_us = lora_time_on_air_us(FRAME_BATCH_LEN(FRAME_BATCH_MAX)) +
+                      FRAME_ACK_DELAY_MAX_MS * 1000 + lora_time_on_air_us(sizeof(frame_ack_t));
+    if (arq_us > airtime_us) airtime_us = arq_us;
+#endif
+#if TDMA_FEC
+    // Paridade de um grupo de leituras: símbolo [tamanho][quadro]
+    uint32_t parity_us = lora_time_on_air_us(FRAME_PARITY_LEN(1 + sizeof(frame_sensor_t)));
+    if (parity_us > airtime_us) airtime_us = parity_us;
+#endif
+
+    // LBT dos nós: um CAD ocupado, a primeira janela de backoff e o CAD
+    // seguinte. Além disso o nó desiste do envio em vez de invadir o
+    // slot seguinte.
+    airtime_us += 2 * lora_cad_time_us() + TDMA_LBT_BACKOFF_MS * 1000;
+
+    tdma.slot_ms = (uint16_t)((airtime_us + 999) / 1000 + TDMA_GUARD_MS);
+    tdma.superframe = 0;
+    tdma.next_beacon = get_absolute_time();
+    tdma.start = tdma.next_beacon;
+    tdma.channel = LORA_BEACON_CHANNEL;
+    tdma.sf = LORA_SF_MAX;
+    memset(tdma.slot_sf, LORA_SF_MAX, sizeof(tdma.slot_sf));
+
+    printf("[TDMA] %u slots de %u ms, superquadro de %lu ms, saltos em %u canais\n", TDMA_SLOT_COUNT,
+           tdma.slot_ms, (unsigned long)tdma.slot_ms * TDMA_SLOT_COUNT, TDMA_HOP_CHANNELS);
+}
+
+// Slots em cabeçalho implícito: todos os nós ouvidos no slot anunciaram
+// FRAME_FLAG_IMPLICIT. Um nó sem o modo não seria ouvido num slot
+// implícito, então a cada TDMA_IMPLICIT_PROBE superquadros todos ficam
+// explícitos para que ele apareça e segure o slot. Nó em silêncio deixa de
+// contar e, se voltar, anuncia de novo.
+static uint16_t tdma_implicit_slots(uint64_t now_us, uint64_t silence_us) {
+    uint16_t allowed = 0, denied = 0;
+
+    for (int i = 0; i < NODE_TABLE_SIZE; i++) {
+        node_stats_t *n = node_table_at(i);
+        if (!n) continue;
+        if (now_us - n->last_rx_us >= silence_us) {
+            n->implicit_ok = false;
+            continue;
+        }
+        const uint8_t slot = frame_tdma_slot(n->node_id, TDMA_SLOT_COUNT);
+        if (slot >= 16) continue;
+        if (n->implicit_ok) {
+            allowed |= (uint16_t)(1u << slot);
+        } else {
+            denied |= (uint16_t)(1u << slot);
+        }
+    }
+    return allowed & (uint16_t)~denied;
+}
+
+// Envia o beacon na hora e devolve o rádio à recepção quando ele termina.
+// Não bloqueia: o beacon leva mais de um segundo no ar em SF12.
+static void tdma_task(void) {
+    if (radio_tx_active) return;
+    if (!time_reached(tdma.next_beacon)) return;
+
+    // Modo de cabeçalho de cada slot deste superquadro, anunciado no beacon
+    const uint64_t superframe_us = (uint64_t)tdma.slot_ms * TDMA_SLOT_COUNT * 1000;
+    const uint64_t silence_us = (ADR_FALLBACK_SUPERFRAMES + NODE_SAMPLE_INTERVAL) * superframe_us;
+    const uint16_t granted = tdma_implicit_slots(time_us_64(), silence_us);
+    if (granted != tdma.implicit_granted) {
+        printf("[TDMA] Slots em cabeçalho implícito: 0x%04x\n", granted);
+        tdma.implicit_granted = granted;
+    }
+    tdma.implicit_slots = tdma.superframe % TDMA_IMPLICIT_PROBE == 0 ? 0 : granted;
+
+    // Instante real do envio: os nós medem o desvio entre beacons
+    frame_beacon_t beacon = {
+        .header = {
+            .node_id = FRAME_NODE_GATEWAY,
+            .type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_BEACON, 0),
+            .seq = tdma.superframe,
+        },
+        .timestamp_ms = to_ms_since_boot(get_absolute_time()),
+        .slot_ms = tdma.slot_ms,
+        .slot_count = TDMA_SLOT_COUNT,
+        .hop_channels = TDMA_HOP_CHANNELS,
+        .implicit_slots = tdma.implicit_slots,
+    };
+
+    // Todos os nós ouvem o beacon: canal fixo, SF máximo e cabeçalho explícito
+    if (tdma.channel != LORA_BEACON_CHANNEL || tdma.sf != LORA_SF_MAX || tdma.implicit) {
+        lora_set_channel(LORA_BEACON_CHANNEL);
+        lora_set_sf(LORA_SF_MAX);
+        lora_set_implicit_header(0);
+        tdma.channel = LORA_BEACON_CHANNEL;
+        tdma.sf = LORA_SF_MAX;
+        tdma.implicit = false;
+    }
+    if (!radio_send_async(&beacon, FRAME_BEACON_LEN)) {
+        printf("[AVISO] Beacon %u não enviado.\n", tdma.superframe);
+    }
+    // O superquadro conta mesmo sem beacon: os nós sincronizados seguem
+    // pela previsão e saltam pelo mesmo número
+    tdma.superframe++;
+
+    // Taxas dos slots deste superquadro: os nós aplicam depois do beacon o
+    // que receberam nos ACKs do anterior
+    adr_check_silent(time_us_64(), (ADR_CONFIRM_SUPERFRAMES + NODE_SAMPLE_INTERVAL) * superframe_us, silence_us);
+    for (uint8_t slot = 1; slot < TDMA_SLOT_COUNT; slot++) {
+        tdma.slot_sf[slot] = adr_slot_sf(slot, TDMA_SLOT_COUNT);
+    }
+
+    // Período fixo a partir da agenda, não do atraso desta volta do loop
+    tdma.start = tdma.next_beacon;
+    tdma.next_beacon = delayed_by_ms(tdma.next_beacon, (uint32_t)tdma.slot_ms * TDMA_SLOT_COUNT);
+}
+
+// Fim do slot em curso (time_us_64()); 0 fora dos slots dos nós
+static uint64_t tdma_slot_end_us(void) {
+    int64_t elapsed_us = absolute_time_diff_us(tdma.start, get_absolute_time());
+    if (elapsed_us < 0) return 0;
+    uint32_t slot = (uint32_t)(elapsed_us / 1000 / tdma.slot_ms);
+    if (slot < 1 || slot >= TDMA_SLOT_COUNT) return 0;
+    return to_us_since_boot(tdma.start) + (uint64_t)(slot + 1) * tdma.slot_ms * 1000;
+}
+
+// Concede o despejo do log pedido no lote se o enlace aguenta o FSK e o
+// resto do slot cabe ao menos uma janela
+static bool bulk_grant_check(const frame_batch_t *frame, const node_stats_t *node, uint64_t now_us) {
+    if (!(FRAME_FLAGS(&frame->header) & FRAME_FLAG_BULK)) return false;
+    if (node->snr_db < BULK_MIN_SNR_DB) return false;
+
+    uint64_t end_us = tdma_slot_end_us();
+    if (end_us < now_us + BULK_MIN_SLOT_MS * 1000) return false;
+
+    bulk_grant.node_id = frame->header.node_id;
+    bulk_grant.end_us = end_us;
+    return true;
+}
+
+// Acompanha os saltos: em cada slot o rádio ouve no canal, no SF e no modo
+// de cabeçalho do nó dono dele. Só troca na virada do slot; os nós
+// transmitem no meio.
+static void hop_task(void) {
+    if (radio_tx_active) return;
+
+    int64_t elapsed_us = absolute_time_diff_us(tdma.start, get_absolute_time());
+    uint32_t slot = elapsed_us < 0 ? 0 : (uint32_t)(elapsed_us / 1000 / tdma.slot_ms);
+    uint8_t channel = slot >= TDMA_SLOT_COUNT
+        ? LORA_BEACON_CHANNEL
+        : lora_hop_channel((uint16_t)(tdma.superframe - 1), (uint8_t)slot, TDMA_HOP_CHANNELS);
+    uint8_t sf = slot >= 1 && slot < TDMA_SLOT_COUNT ? tdma.slot_sf[slot] : LORA_SF_MAX;
+    bool implicit = slot >= 1 && slot < TDMA_SLOT_COUNT && (tdma.implicit_slots & (1u << slot));
+
+    if (channel == tdma.channel && sf == tdma.sf && implicit == tdma.implicit) return;
+    tdma.channel = channel;
+    tdma.sf = sf;
+    tdma.implicit = implicit;
+    lora_set_channel(channel);
+    lora_set_sf(sf);
+    lora_set_implicit_header(implicit ? FRAME_IMPLICIT_LEN : 0);
+    lora_start_rx_continuous();
+}
+
+// Trata um quadro de leitura: contabiliza o nó e atualiza a tela
+static void handle_sensor_frame(const frame_sensor_t *frame, uint64_t now_us) {
+    node_stats_t *node;
+    node_rx_result_t result = node_table_update(&frame->header, now_us, &node);
+
+    if (result == NODE_RX_TABLE_FULL) {
+        printf("[AVISO] Tabela de nós cheia, nó %u ignorado.\n", frame->header.node_id);
+        return;
+    }
+    node_link_update(node, lora_get_snr(), lora_get_rssi());
+    node->implicit_ok = (FRAME_FLAGS(&frame->header) & FRAME_FLAG_IMPLICIT) != 0;
+    if (result == NODE_RX_DUPLICATE) return;
+
+    node_stats_print(node);
+    display_post_sensor_data(frame->temperatura, frame->umidade);
+}
+
+// Trata um lote do ARQ: descarta amostras repetidas, mostra a mais nova e
+// responde na hora com o ACK seletivo, dentro da janela do nó
+static void handle_batch_frame(const uint8_t *quadro, int len, uint64_t now_us) {
+    frame_batch_t frame;
+    size_t count = FRAME_BATCH_COUNT((size_t)len);
+    node_stats_t *node;
+
+    memcpy(&frame, quadro, (size_t)len);
+    node_rx_result_t result = node_table_update(&frame.header, now_us, &node);
+    if (result == NODE_RX_TABLE_FULL) {
+        printf("[AVISO] Tabela de nós cheia, nó %u ignorado.\n", frame.header.node_id);
+        return;
+    }
+    adr_on_report(node, frame.adr);
+    node_link_update(node, lora_get_snr(), lora_get_rssi());
+    node->implicit_ok = false; // Lotes variam de tamanho
+
+    const frame_sample_t *newest = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (node_sample_accept(node, frame.samples[i].seq)) {
+            newest = &frame.samples[i];
+        }
+    }
+
+    if (FRAME_FLAGS(&frame.header) & FRAME_FLAG_ACK_REQ) {
+        frame_ack_t ack = {
+            .header = {
+                .node_id = frame.header.node_id,
+                .type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_ACK, 0),
+                .seq = frame.header.seq,
+            },
+            .interval = NODE_SAMPLE_INTERVAL,
+        };
+        node_sample_ack(node, &ack.base_seq, &ack.bitmap);
+
+        // Taxa e potência para o próximo superquadro, repetidas em todo ACK
+        adr_evaluate(node);
+        ack.adr = adr_command(node, TDMA_SLOT_COUNT);
+        if (!radio_tx_active && bulk_grant_check(&frame, node, now_us)) {
+            ack.header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_ACK, FRAME_FLAG_BULK);
+        }
+        if (!radio_send_async(&ack, sizeof(ack))) {
+            printf("[AVISO] Rádio ocupado, ACK para o nó %u não enviado.\n", frame.header.node_id);
+        }
+    }
+
+    if (result == NODE_RX_DUPLICATE) return;
+    node_stats_print(node);
+    if (newest) {
+        display_post_sensor_data(newest->temperatura, newest->umidade);
+    }
+}
+
+// Quadro reconstruído pela paridade: já passou, então só desfaz a perda
+// nas estatísticas; a tela segue com a leitura mais nova
+static void handle_recovered_frame(const uint8_t *quadro, size_t len) {
+    frame_header_t header;
+    node_stats_t *node;
+
+    memcpy(&header, quadro, sizeof(header));
+    if (FRAME_TYPE(&header) != FRAME_TYPE_SENSOR || len != sizeof(frame_sensor_t)) return;
+
+    node_rx_result_t result = node_table_recovered(&header, &node);
+    if (result == NODE_RX_DUPLICATE || result == NODE_RX_TABLE_FULL) return;
+
+    fec_rx_stats_t fec = fec_rx_get_stats();
+    printf("[FEC] Quadro %u do nó %u recuperado (total %lu, grupos perdidos %lu)\n",
+           header.seq, header.node_id, (unsigned long)fec.recovered, (unsigned long)fec.unrecoverable);
+    node_stats_print(node);
+}
+
+// Leitura do log despejada em FSK: já foi medida, só conta para o nó
+static void handle_bulk_sample(uint8_t node_id, const frame_sample_t *sample) {
+    (void)sample;
+    node_stats_t *node = node_table_find(node_id);
+    if (node) node->bulk_samples++;
+}
+
+// Totais do receptor desde o boot, logo após o resumo do despejo
+static void bulk_stats_print(void) {
+    bulk_rx_stats_t bulk = bulk_rx_get_stats();
+    printf("[BULK] Total: %lu despejos, %lu fragmentos (%lu repetidos), %lu leituras\n",
+           (unsigned long)bulk.sessions, (unsigned long)bulk.fragments, (unsigned long)bulk.duplicates,
+           (unsigned long)bulk.samples);
+}
+
 // ==========================================================
 // ===                     FUNÇÃO PRINCIPAL               ===
 // ==========================================================
 
 int main() {
-    sensor_packet_t pacote_recebido;
+    uint8_t quadro[LORA_FRAME_MAX];
     bool primeira_leitura = true;
 
     init_lora_system();
+    node_table_reset();
+    fec_rx_init(handle_recovered_frame);
+    bulk_rx_init(handle_bulk_sample);
+    tdma_init();
     show_sync_screen();
 
     while (1) {
-        int len = lora_receive_bytes((uint8_t *)&pacote_recebido, sizeof(pacote_recebido));
+        // Despejo em curso: o rádio está em FSK até o fim do slot do nó. A
+        // tela espera: o I2C atrasaria a leitura do FIFO entre fragmentos
+        if (bulk_rx_active()) {
+            bulk_rx_task();
+            if (!bulk_rx_active()) bulk_stats_print();
+            continue;
+        }
 
-        if (len == sizeof(pacote_recebido)) {
-            if (primeira_leitura) {
-                cancel_repeating_timer(&sync_timer);
-                ssd1306_Fill(Black);
+        int len = lora_receive_bytes(quadro, sizeof(quadro));
+        uint64_t agora = time_us_64();
+
+        if (len >= (int)sizeof(frame_header_t)) {
+            frame_header_t header;
+            memcpy(&header, quadro, sizeof(header));
+
+            // Guardado antes de tratar: a paridade do grupo vem depois. O bit
+            // é o mesmo de FRAME_FLAG_BULK nos lotes
+            if (FRAME_TYPE(&header) == FRAME_TYPE_SENSOR && (FRAME_FLAGS(&header) & FRAME_FLAG_FEC)) {
+                fec_rx_data(quadro, (size_t)len);
             }
 
-            float temp = (float)pacote_recebido.temperatura / 100;
-            float umid = (float)pacote_recebido.umidade / 100;
+            if (FRAME_TYPE(&header) == FRAME_TYPE_SENSOR && len == sizeof(frame_sensor_t)) {
+                frame_sensor_t frame;
+                memcpy(&frame, quadro, sizeof(frame));
 
-            show_sensor_data(temp, umid);
-            primeira_leitura = false;
+                if (primeira_leitura) {
+                    stop_sync_screen();
+                    primeira_leitura = false;
+                }
+                handle_sensor_frame(&frame, agora);
+            } else if (FRAME_TYPE(&header) == FRAME_TYPE_BATCH && len > (int)FRAME_BATCH_LEN(0) &&
+                       len <= (int)sizeof(frame_batch_t) &&
+                       (len - FRAME_BATCH_LEN(0)) % sizeof(frame_sample_t) == 0) {
+                if (primeira_leitura) {
+                    stop_sync_screen();
+                    primeira_leitura = false;
+                }
+                handle_batch_frame(quadro, len, agora);
+            } else if (FRAME_TYPE(&header) == FRAME_TYPE_PARITY) {
+                if (!fec_rx_parity(quadro, (size_t)len)) {
+                    printf("[AVISO] Paridade inválida do nó %u (%d bytes).\n", header.node_id, len);
+                }
+            } else {
+                printf("[AVISO] Quadro tipo %u com %d bytes ignorado.\n", FRAME_TYPE(&header), len);
+            }
         }
+
+        radio_task();
+        tdma_task();
+        hop_task();
+        render_task();
     }
 
     return 0;
@@ -0,0 +1,201 @@
+/*
+ * Host benchmark and self-check of the frame-level erasure code.
+ *
+ * Codec: encode and decode throughput for a few (k, m) group shapes, with
+ * full-size symbols and m data symbols erased before each decode.
+ *
+ * Channel: sensor frames go through the node's encoder (fec_tx) and every
+ * data and parity frame is dropped with probability p before reaching the
+ * gateway's decoder (fec_rx). Reports how many frames arrive over the air
+ * and how many once recovered ones are added, against the airtime spent on
+ * parity. Every recovered frame is compared with the one that was sent.
+ *
+ * Usage: fec_bench
+ * Exits with 1 if a decode produces wrong data.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "fec.h"
+#include "fec_rx.h"
+#include "../../../../hardware/firmware/fec_tx.h"
+
+// Minimum time spent timing each codec case
+#define BENCH_MIN_NS 200000000ull
+
+// Sensor frames sent per channel case
+#define CHANNEL_FRAMES 20000
+
+#define BENCH_NODE_ID 7
+
+typedef struct {
+    uint8_t k, m;
+} shape_t;
+
+static const shape_t shapes[] = {{4, 1}, {4, 2}, {8, 2}, {8, 4}};
+static const unsigned loss_percent[] = {5, 10, 20, 30};
+
+static int failures = 0;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// xorshift32: same sequence on every run
+static uint32_t rng_state = 0x12345678u;
+static uint32_t rng(void) {
+    uint32_t x = rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return rng_state = x;
+}
+
+// ==========================================================
+// Codec throughput
+
+static void bench_codec(shape_t s) {
+    static uint8_t data[FEC_MAX_K][FRAME_FEC_SYMBOL_MAX];
+    static uint8_t work[FEC_MAX_K][FRAME_FEC_SYMBOL_MAX];
+    static uint8_t parity[FEC_MAX_M][FRAME_FEC_SYMBOL_MAX];
+    uint8_t *work_ptr[FEC_MAX_K];
+    const uint8_t *parity_ptr[FEC_MAX_M];
+    uint8_t rows[FEC_MAX_M];
+    const size_t len = FRAME_FEC_SYMBOL_MAX;
+
+    for (int i = 0; i < s.k; i++) {
+        for (size_t j = 0; j < len; j++) data[i][j] = (uint8_t)rng();
+        work_ptr[i] = work[i];
+    }
+    for (int r = 0; r < s.m; r++) {
+        parity_ptr[r] = parity[r];
+        rows[r] = (uint8_t)r;
+    }
+
+    // Encode: a whole group into m parity rows
+    uint64_t runs = 0, start = now_ns(), elapsed;
+    do {
+        memset(parity, 0, sizeof(parity));
+        for (int r = 0; r < s.m; r++) {
+            for (int i = 0; i < s.k; i++) fec_encode(parity[r], (uint8_t)r, (uint8_t)i, data[i], len);
+        }
+        runs++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    const double enc_mbs = (double)runs * s.k * len / (elapsed / 1e9) / 1e6;
+
+    // Decode: the first m data symbols lost, all parity rows received
+    const uint32_t have = ((1u << s.k) - 1) & ~((1u << s.m) - 1);
+    runs = 0;
+    start = now_ns();
+    do {
+        for (int i = s.m; i < s.k; i++) memcpy(work[i], data[i], len);
+        if (fec_decode(s.k, work_ptr, have, parity_ptr, rows, s.m, len) != s.m) failures++;
+        runs++;
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+    const double dec_mbs = (double)runs * s.k * len / (elapsed / 1e9) / 1e6;
+
+    int ok = 1;
+    for (int i = 0; i < s.m; i++) ok &= memcmp(work[i], data[i], len) == 0;
+    if (!ok) failures++;
+
+    printf("k=%u m=%u  encode %8.1f MB/s  decode (%u lost) %8.1f MB/s  %s\n",
+           s.k, s.m, enc_mbs, s.m, dec_mbs, ok ? "ok" : "WRONG DATA");
+}
+
+// ==========================================================
+// Lossy channel
+
+static frame_sensor_t sent[CHANNEL_FRAMES];
+static uint32_t delivered_over_air, delivered_recovered;
+static uint8_t seen[CHANNEL_FRAMES];
+
+static void on_recovered(const uint8_t *frame, size_t len) {
+    frame_sensor_t f;
+
+    if (len != sizeof(f)) {
+        failures++;
+        return;
+    }
+    memcpy(&f, frame, sizeof(f));
+    if (f.header.seq >= CHANNEL_FRAMES || seen[f.header.seq] ||
+        memcmp(&f, &sent[f.header.seq], sizeof(f)) != 0) {
+        failures++;
+        return;
+    }
+    seen[f.header.seq] = 1;
+    delivered_recovered++;
+}
+
+static void bench_channel(shape_t s, unsigned p) {
+    const uint32_t drop_below = (uint32_t)((uint64_t)p * 0xFFFFFFFFu / 100);
+    uint32_t frames_on_air = 0;
+
+    fec_tx_init(s.k, s.m);
+    fec_rx_init(on_recovered);
+    memset(seen, 0, sizeof(seen));
+    delivered_over_air = delivered_recovered = 0;
+
+    for (uint16_t seq = 0; seq < CHANNEL_FRAMES; seq++) {
+        frame_sensor_t *f = &sent[seq];
+        f->header.node_id = BENCH_NODE_ID;
+        f->header.type_flags = FRAME_TYPE_FLAGS(FRAME_TYPE_SENSOR, FRAME_FLAG_FEC);
+        f->header.seq = seq;
+        f->temperatura = (int16_t)(rng() % 5000);
+        f->umidade = (int16_t)(rng() % 10000);
+
+        fec_tx_add((const uint8_t *)f, sizeof(*f));
+        frames_on_air++;
+        if (rng() >= drop_below) {
+            fec_rx_data((const uint8_t *)f, sizeof(*f));
+            seen[seq] = 1;
+            delivered_over_air++;
+        }
+
+        while (fec_tx_parity_pending()) {
+            frame_parity_t parity;
+            const size_t len = fec_tx_next_parity(&parity, BENCH_NODE_ID);
+            frames_on_air++;
+            if (rng() >= drop_below && !fec_rx_parity((const uint8_t *)&parity, len)) failures++;
+        }
+    }
+
+    const fec_rx_stats_t st = fec_rx_get_stats();
+    if (st.recovered != delivered_recovered) failures++;
+
+    printf("k=%u m=%u  loss %2u%%  delivered %5.1f%% -> %5.1f%%  airtime +%3.0f%%  unrecoverable groups %lu\n",
+           s.k, s.m, p,
+           100.0 * delivered_over_air / CHANNEL_FRAMES,
+           100.0 * (delivered_over_air + delivered_recovered) / CHANNEL_FRAMES,
+           100.0 * (frames_on_air - CHANNEL_FRAMES) / CHANNEL_FRAMES,
+           (unsigned long)st.unrecoverable);
+}
+
+int main(void) {
+    const size_t shape_count = sizeof(shapes) / sizeof(shapes[0]);
+
+    fec_init();
+
+    printf("Codec, %u-byte symbols\n", FRAME_FEC_SYMBOL_MAX);
+    for (size_t i = 0; i < shape_count; i++) bench_codec(shapes[i]);
+
+    printf("\nChannel, %u frames, independent losses\n", CHANNEL_FRAMES);
+    for (size_t i = 0; i < shape_count; i++) {
+        for (size_t j = 0; j < sizeof(loss_percent) / sizeof(loss_percent[0]); j++) {
+            bench_channel(shapes[i], loss_percent[j]);
+        }
+    }
+
+    if (failures) {
+        printf("\n%d FAILURES\n", failures);
+        return 1;
+    }
+    return 0;
+}
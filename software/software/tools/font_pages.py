@@ -0,0 +1,178 @@
+#!/usr/bin/env python3
+"""
+Converts the row-major uint16_t font tables of ssd1306_fonts.c into the
+SSD1306 native page/column layout used by the glyph blitter.
+
+Each glyph becomes ceil(height / 8) pages of `width` bytes. Bit k of byte x
+in page p is the pixel at column x, row 8 * p + k, exactly like the
+framebuffer, so glyphs are drawn 8 vertical pixels at a time.
+
+Fonts can be reduced to the characters the firmware actually prints with
+--subset WxH=CHARS (a 95 entry map then translates ch - 32 into the packed
+glyph index, 0xFF for dropped glyphs), and --rle PackBits-compresses every
+glyph when that makes the font smaller, with a per-glyph offset table so the
+driver can unpack a single glyph into a small stack buffer.
+
+Usage: font_pages.py <ssd1306_fonts.c> <output.c> [--rle] [--subset WxH=CHARS]...
+"""
+
+import argparse
+import re
+import sys
+
+FIRST_CHAR = 32
+GLYPHS = 95  # ' ' .. '~'
+GLYPH_NONE = 0xFF
+GLYPH_MAX_BYTES = 64  # SSD1306_GLYPH_MAX_BYTES, unpack buffer in ssd1306_WriteChar
+
+
+def strip_comments(src):
+    src = re.sub(r"/\*.*?\*/", "", src, flags=re.S)
+    return re.sub(r"//[^\n]*", "", src)
+
+
+def parse_arrays(src, ctype):
+    arrays = {}
+    pattern = r"static const %s (\w+)\s*\[\]\s*=\s*\{(.*?)\};" % ctype
+    for name, body in re.findall(pattern, src, flags=re.S):
+        arrays[name] = [int(v, 0) for v in re.findall(r"0[xX][0-9a-fA-F]+|\d+", body)]
+    return arrays
+
+
+def parse_fonts(src):
+    # Members after char_width (page data etc.) are ignored
+    pattern = (r"const SSD1306_Font_t (\w+)\s*=\s*\{\s*(\d+)\s*,\s*(\d+)\s*,"
+               r"\s*(\w+)\s*,\s*(\w+)\s*(?:,[^}]*)?\}")
+    return [(name, int(w), int(h), data, widths)
+            for name, w, h, data, widths in re.findall(pattern, src)]
+
+
+def to_pages(rows, width, height):
+    pages = (height + 7) // 8
+    out = []
+    for ch in range(GLYPHS):
+        glyph = rows[ch * height:(ch + 1) * height]
+        glyph += [0] * (height - len(glyph))  # Missing glyphs are blank
+        for p in range(pages):
+            for x in range(width):
+                byte = 0
+                for k in range(8):
+                    y = p * 8 + k
+                    if y < height and (glyph[y] << x) & 0x8000:
+                        byte |= 1 << k
+                out.append(byte)
+    return out
+
+
+def packbits(data):
+    # n >= 0: n + 1 literal bytes follow, n < 0: next byte repeated 1 - n times
+    out = []
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run > 1:
+            out += [(1 - run) & 0xFF, data[i]]
+            i += run
+            continue
+        start = i
+        while (i < len(data) and i - start < 128
+               and not (i + 1 < len(data) and data[i + 1] == data[i])):
+            i += 1
+        out += [i - start - 1] + data[start:i]
+    return out
+
+
+def c_bytes(values, per_line):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append("".join("0x%02X," % v for v in values[i:i + per_line]))
+    return "\n".join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    parser.add_argument("src")
+    parser.add_argument("out")
+    parser.add_argument("--rle", action="store_true",
+                        help="PackBits-compress glyphs when it saves space")
+    parser.add_argument("--subset", action="append", default=[], metavar="WxH=CHARS",
+                        help="only keep CHARS in Font_WxH")
+    args = parser.parse_args()
+
+    subsets = {}
+    for spec in args.subset:
+        size, sep, chars = spec.partition("=")
+        if not sep:
+            parser.error("bad --subset %r" % spec)
+        subsets["Font_" + size] = sorted({ord(c) - FIRST_CHAR for c in chars
+                                          if FIRST_CHAR <= ord(c) < FIRST_CHAR + GLYPHS})
+
+    with open(args.src) as f:
+        src = strip_comments(f.read())
+
+    rows = parse_arrays(src, "uint16_t")
+    widths = parse_arrays(src, "uint8_t")
+
+    out = [
+        "/* Generated by tools/font_pages.py from ssd1306_fonts.c - do not edit */",
+        "",
+        '#include "ssd1306_fonts.h"',
+        "",
+    ]
+    for name, width, height, data, char_width in parse_fonts(src):
+        guard = "SSD1306_INCLUDE_FONT_" + name[len("Font_"):]
+        glyph_size = width * ((height + 7) // 8)
+        pages = to_pages(rows[data], width, height)
+        kept = subsets.get(name, list(range(GLYPHS)))
+        glyphs = [pages[g * glyph_size:(g + 1) * glyph_size] for g in kept]
+
+        out.append("#ifdef %s" % guard)
+        map_ref = "NULL"
+        if len(kept) < GLYPHS:
+            glyph_map = [GLYPH_NONE] * GLYPHS
+            for index, g in enumerate(kept):
+                glyph_map[g] = index
+            map_ref = "%s_glyph_map" % data
+            out.append("static const uint8_t %s[] = {" % map_ref)
+            out.append(c_bytes(glyph_map, 16))
+            out.append("};")
+
+        offsets_ref = "NULL"
+        raw = sum(glyphs, [])
+        packed = [packbits(g) for g in glyphs]
+        packed_size = sum(len(p) for p in packed) + 2 * len(packed)
+        if args.rle and glyph_size <= GLYPH_MAX_BYTES and packed_size < len(raw):
+            offsets, offset = [], 0
+            for p in packed:
+                offsets.append(offset)
+                offset += len(p)
+            offsets_ref = "%s_offsets" % data
+            out.append("static const uint16_t %s[] = {" % offsets_ref)
+            out.append(",".join("%d" % o for o in offsets) + ",")
+            out.append("};")
+        out.append("static const uint8_t %s_pages[] = {" % data)
+        if offsets_ref == "NULL":
+            out.append(c_bytes(raw, glyph_size))
+        else:
+            out.extend(c_bytes(p, len(p)) for p in packed)
+        out.append("};")
+
+        widths_ref = "NULL"
+        if char_width != "NULL":
+            widths_ref = "%s_char_width" % data
+            out.append("static const uint8_t %s[] = {" % widths_ref)
+            out.append(c_bytes(widths[char_width], 16))
+            out.append("};")
+        out.append("const SSD1306_Font_t %s = {%d, %d, NULL, %s, %s_pages, %s, %s};"
+                   % (name, width, height, widths_ref, data, map_ref, offsets_ref))
+        out.append("#endif")
+        out.append("")
+
+    with open(args.out, "w") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,249 @@
+/*
+ * Host benchmark and golden-image check of the SSD1306 driver.
+ *
+ * Every primitive is timed on the host CPU against the emulated panel;
+ * flushes also report the bytes they put on the bus and the resulting bus
+ * time at SSD1306_I2C_CLK. Each primitive also draws a reference scene
+ * which is flushed to the emulator and can be saved (--dump DIR) or
+ * compared with saved images (--check DIR).
+ *
+ * Usage: ssd1306_bench [--dump DIR | --check DIR]
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include "ssd1306_emu.h"
+
+// Minimum time spent timing each primitive
+#define BENCH_MIN_NS 20000000ull
+
+typedef struct {
+    const char *name;
+    void (*draw)(uint32_t i); // i varies the arguments between runs
+} bench_t;
+
+static const uint8_t bench_bitmap[32 * 32 / 8] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x01, 0xBF, 0xFF, 0xFF, 0xFD, 0xA0, 0x00, 0x00, 0x05,
+    0xAF, 0xFF, 0xFF, 0xF5, 0xA8, 0x00, 0x00, 0x15, 0xAB, 0xFF, 0xFF, 0xD5, 0xAA, 0x00, 0x00, 0x55,
+    0xAA, 0xFF, 0xFF, 0x55, 0xAA, 0x80, 0x01, 0x55, 0xAA, 0xBF, 0xFD, 0x55, 0xAA, 0xA0, 0x05, 0x55,
+    0xAA, 0xAF, 0xF5, 0x55, 0xAA, 0xA8, 0x15, 0x55, 0xAA, 0xAB, 0xD5, 0x55, 0xAA, 0xAA, 0x55, 0x55,
+    0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAB, 0xD5, 0x55, 0xAA, 0xA8, 0x15, 0x55, 0xAA, 0xAF, 0xF5, 0x55,
+    0xAA, 0xA0, 0x05, 0x55, 0xAA, 0xBF, 0xFD, 0x55, 0xAA, 0x80, 0x01, 0x55, 0xAA, 0xFF, 0xFF, 0x55,
+    0xAA, 0x00, 0x00, 0x55, 0xAB, 0xFF, 0xFF, 0xD5, 0xA8, 0x00, 0x00, 0x15, 0xAF, 0xFF, 0xFF, 0xF5,
+    0xA0, 0x00, 0x00, 0x05, 0xBF, 0xFF, 0xFF, 0xFD, 0x80, 0x00, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static const SSD1306_VERTEX bench_polyline[] = {
+    {4, 60}, {30, 10}, {60, 50}, {90, 4}, {124, 40},
+};
+
+static void draw_pixel(uint32_t i)
+{
+    ssd1306_DrawPixel(i % SSD1306_WIDTH, (i / SSD1306_WIDTH) % SSD1306_HEIGHT, White);
+}
+
+static void draw_hline(uint32_t i)
+{
+    ssd1306_DrawHLine(3, 120, 5 + i % 50, White);
+}
+
+static void draw_line(uint32_t i)
+{
+    ssd1306_Line(0, i % 8, 127, 63 - i % 8, White);
+}
+
+static void draw_polyline(uint32_t i)
+{
+    (void)i;
+    ssd1306_Polyline(bench_polyline, sizeof(bench_polyline) / sizeof(bench_polyline[0]), White);
+}
+
+static void draw_circle(uint32_t i)
+{
+    ssd1306_DrawCircle(64, 32, 20 + i % 8, White);
+}
+
+static void fill_circle(uint32_t i)
+{
+    ssd1306_FillCircle(64, 32, 20 + i % 8, White);
+}
+
+static void draw_arc(uint32_t i)
+{
+    ssd1306_DrawArc(64, 32, 28, i % 90, 270, White);
+}
+
+static void draw_rectangle(uint32_t i)
+{
+    ssd1306_DrawRectangle(10 + i % 4, 5, 110, 58, White);
+}
+
+static void fill_rectangle(uint32_t i)
+{
+    ssd1306_FillRectangle(10 + i % 4, 5, 110, 58, White);
+}
+
+static void invert_rectangle(uint32_t i)
+{
+    ssd1306_InvertRectangle(10 + i % 4, 5, 110, 58);
+}
+
+static void fill_screen(uint32_t i)
+{
+    ssd1306_Fill((i & 1) ? Black : White);
+}
+
+static void write_char(uint32_t i)
+{
+    ssd1306_SetCursor(2 + i % 4, 5 + i % 8);
+    ssd1306_WriteChar('0' + i % 10, Font_16x24, White);
+}
+
+static void write_string(uint32_t i)
+{
+    ssd1306_SetCursor(2, 5 + i % 8);
+    ssd1306_WriteString("23.45C", Font_16x24, White);
+    ssd1306_SetCursor(2, 40);
+    ssd1306_WriteString("Sincronizando", Font_16x15, White);
+}
+
+static void draw_bitmap(uint32_t i)
+{
+    ssd1306_DrawBitmap(48 + i % 4, 16 + i % 8, bench_bitmap, 32, 32, White);
+}
+
+static void update_screen(uint32_t i)
+{
+    (void)i;
+    ssd1306_UpdateScreen();
+}
+
+static void update_window(uint32_t i)
+{
+    // One column of the trend charts
+    ssd1306_UpdateWindow(127 - i % 30, 127 - i % 30, 0, 2);
+}
+
+static const bench_t benches[] = {
+    {"pixel", draw_pixel},
+    {"hline", draw_hline},
+    {"line", draw_line},
+    {"polyline", draw_polyline},
+    {"circle", draw_circle},
+    {"fill_circle", fill_circle},
+    {"arc", draw_arc},
+    {"rectangle", draw_rectangle},
+    {"fill_rectangle", fill_rectangle},
+    {"invert_rectangle", invert_rectangle},
+    {"fill", fill_screen},
+    {"char", write_char},
+    {"string", write_string},
+    {"bitmap", draw_bitmap},
+    {"flush", update_screen},
+    {"flush_window", update_window},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+// Reference scene of a primitive as it appears on the emulated glass
+static bool scene(const bench_t *b, const char *dump, const char *check)
+{
+    char path[256], golden[256];
+
+    ssd1306_Fill(Black);
+    b->draw(0);
+    ssd1306_UpdateScreen();
+
+    if (dump)
+    {
+        snprintf(path, sizeof(path), "%s/%s.pgm", dump, b->name);
+        if (!ssd1306_emu_save_pgm(path))
+        {
+            fprintf(stderr, "cannot write %s\n", path);
+            return false;
+        }
+    }
+
+    if (check)
+    {
+        snprintf(golden, sizeof(golden), "%s/%s.pgm", check, b->name);
+        snprintf(path, sizeof(path), "%s/%s.new.pgm", check, b->name);
+
+        FILE *f = fopen(golden, "rb");
+        uint8_t expected[64 + SSD1306_EMU_WIDTH * SSD1306_EMU_HEIGHT];
+        size_t len = f ? fread(expected, 1, sizeof(expected), f) : 0;
+        if (f)
+            fclose(f);
+
+        uint8_t image[SSD1306_EMU_HEIGHT][SSD1306_EMU_WIDTH];
+        ssd1306_emu_render(image);
+        if (len < sizeof(image) ||
+            memcmp(&expected[len - sizeof(image)], image, sizeof(image)) != 0)
+        {
+            ssd1306_emu_save_pgm(path);
+            fprintf(stderr, "%s: differs from %s, see %s\n", b->name, golden, path);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *dump = NULL, *check = NULL;
+    bool ok = true;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--dump") && i + 1 < argc)
+            dump = argv[++i];
+        else if (!strcmp(argv[i], "--check") && i + 1 < argc)
+            check = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--dump DIR | --check DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ssd1306_emu_reset();
+    ssd1306_Init();
+    ssd1306_emu_reset_stats();
+
+    printf("%-18s %12s %12s %12s\n", "primitive", "ns/op", "bus B/op", "bus us/op");
+    for (size_t n = 0; n < sizeof(benches) / sizeof(benches[0]); n++)
+    {
+        const bench_t *b = &benches[n];
+        uint32_t runs = 0;
+
+        ok &= scene(b, dump, check);
+
+        ssd1306_Fill(Black);
+        ssd1306_emu_reset_stats();
+        const uint64_t start = now_ns();
+        uint64_t elapsed;
+        do
+        {
+            for (uint32_t k = 0; k < 64; k++, runs++)
+                b->draw(runs);
+            elapsed = now_ns() - start;
+        } while (elapsed < BENCH_MIN_NS);
+
+        const ssd1306_emu_stats_t stats = ssd1306_emu_stats();
+        printf("%-18s %12.1f %12.1f %12.1f\n", b->name, (double)elapsed / runs,
+               (double)stats.bytes / runs, (double)ssd1306_emu_bus_us(stats, SSD1306_I2C_CLK) / runs);
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,459 @@
+/*
+ * Host check of the optimised SSD1306 drawing paths against the original
+ * per-pixel and floating-point ones (ssd1306_ref.c).
+ *
+ * Check: every case is drawn by the driver and by the reference over the
+ * same random background; both frames go through the emulator and must
+ * match byte for byte. Glyphs are checked from the page/column tables
+ * (ssd1306_BlitGlyph) and from the row-major ones (ssd1306_BlitBits, also
+ * behind ssd1306_DrawBitmap). Arcs use integer sines instead of sinf() with
+ * 3.14f, so their end points may move by a pixel: every pixel of one frame
+ * must have a lit neighbour (or itself) in the other. Trend charts pushed
+ * with send set must leave the emulated display RAM equal to the
+ * screenbuffer, with or without SSD1306_CONTENT_SCROLL.
+ *
+ * Benchmark: the same draws are timed on both paths and reported as
+ * ns/op, TSC cycles/op (x86 hosts) and the speedup of the driver.
+ *
+ * Usage: ssd1306_check
+ * Exits with 1 if any frame differs.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CHECK_HAVE_TSC 1
+#endif
+#include "ssd1306.h"
+#include "ssd1306_fonts.h"
+#include "ssd1306_emu.h"
+#include "ssd1306_ref.h"
+#include "display_widgets.h"
+
+// Minimum time spent timing each path
+#define BENCH_MIN_NS 50000000ull
+
+typedef struct {
+    const char *name;
+    const SSD1306_Font_t *font; // Page/column tables (driver)
+    const SSD1306_Font_t *ref;  // Row-major tables (reference)
+} font_pair_t;
+
+static const font_pair_t fonts[] = {
+#ifdef SSD1306_INCLUDE_FONT_6x8
+    {"6x8", &Font_6x8, &Ref_Font_6x8},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_7x10
+    {"7x10", &Font_7x10, &Ref_Font_7x10},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_11x18
+    {"11x18", &Font_11x18, &Ref_Font_11x18},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x26
+    {"16x26", &Font_16x26, &Ref_Font_16x26},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x24
+    {"16x24", &Font_16x24, &Ref_Font_16x24},
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x15
+    {"16x15", &Font_16x15, &Ref_Font_16x15},
+#endif
+};
+
+#define FONT_COUNT (sizeof(fonts) / sizeof(fonts[0]))
+
+static uint8_t background[SSD1306_BUFFER_SIZE];
+static uint8_t expected[SSD1306_BUFFER_SIZE];
+
+static uint32_t rng_state = 0x2545F491;
+
+static uint32_t rng(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void new_background(void)
+{
+    for (size_t i = 0; i < sizeof(background); i++)
+        background[i] = (uint8_t)rng();
+}
+
+// Screenbuffer as it reaches the panel
+static void snapshot(uint8_t *out)
+{
+    ssd1306_UpdateScreen();
+    memcpy(out, ssd1306_emu_ram(), SSD1306_BUFFER_SIZE);
+}
+
+// ============================
+// === Pixel checks ===
+// ============================
+
+// One glyph row at (x0, y): every character that fits, both paths. The
+// driver draws from the row-major tables when row_major is set
+static bool check_glyph_row(const font_pair_t *f, bool row_major, uint8_t x0, uint8_t y, char first,
+                            SSD1306_COLOR color, char *next)
+{
+    const SSD1306_Font_t *font = row_major ? f->ref : f->font;
+    char ch;
+
+    ssd1306_FillBuffer(background, sizeof(background));
+    ch = first;
+    for (uint8_t x = x0; x + f->ref->width <= SSD1306_WIDTH && ch <= 126; x += f->ref->width, ch++)
+        ssd1306_RefWriteChar(x, y, ch, *f->ref, color);
+    snapshot(expected);
+
+    ssd1306_FillBuffer(background, sizeof(background));
+    ch = first;
+    for (uint8_t x = x0; x + font->width <= SSD1306_WIDTH && ch <= 126; x += font->width, ch++)
+    {
+        ssd1306_SetCursor(x, y);
+        ssd1306_WriteChar(ch, *font, color);
+    }
+    *next = ch;
+
+    uint8_t actual[SSD1306_BUFFER_SIZE];
+    snapshot(actual);
+    if (memcmp(actual, expected, sizeof(actual)) != 0)
+    {
+        fprintf(stderr, "glyph %s%s: '%c'.. at (%u, %u) %s differs from the per-pixel path\n", f->name,
+                row_major ? " (row-major)" : "", first, x0, y, color == White ? "white" : "black");
+        return false;
+    }
+    return true;
+}
+
+// Every glyph of every font at every y offset, in both colours
+static bool check_glyphs(bool row_major)
+{
+    uint32_t cases = 0;
+    bool ok = true;
+
+    for (size_t n = 0; n < FONT_COUNT; n++)
+    {
+        const font_pair_t *f = &fonts[n];
+        for (uint8_t y = 0; y + f->ref->height <= SSD1306_HEIGHT; y++)
+        {
+            for (int c = 0; c < 2; c++)
+            {
+                const uint8_t x0 = (uint8_t)(rng() % 8);
+                char ch = 32;
+                while (ch <= 126)
+                {
+                    new_background();
+                    ok &= check_glyph_row(f, row_major, x0, y, ch, c ? Black : White, &ch);
+                    cases++;
+                }
+            }
+        }
+    }
+    printf("glyphs (%s): %lu frames %s\n", row_major ? "row-major" : "pages", (unsigned long)cases,
+           ok ? "identical" : "DIFFER");
+    return ok;
+}
+
+// Random bitmaps of every size up to 40x40, partly off the screen
+static bool check_bitmaps(void)
+{
+    static uint8_t bitmap[5 * 40];
+    uint8_t actual[SSD1306_BUFFER_SIZE];
+    uint32_t cases = 0;
+    bool ok = true;
+
+    for (uint8_t w = 1; w <= 40; w++)
+    {
+        for (uint8_t h = 1; h <= 40; h++, cases++)
+        {
+            const uint8_t x = (uint8_t)(rng() % SSD1306_WIDTH);
+            const uint8_t y = (uint8_t)(rng() % SSD1306_HEIGHT);
+            const SSD1306_COLOR color = (rng() & 1) ? White : Black;
+            for (size_t i = 0; i < sizeof(bitmap); i++)
+                bitmap[i] = (uint8_t)rng();
+            new_background();
+
+            ssd1306_FillBuffer(background, sizeof(background));
+            ssd1306_RefDrawBitmap(x, y, bitmap, w, h, color);
+            snapshot(expected);
+
+            ssd1306_FillBuffer(background, sizeof(background));
+            ssd1306_DrawBitmap(x, y, bitmap, w, h, color);
+            snapshot(actual);
+
+            if (memcmp(actual, expected, sizeof(actual)) != 0)
+            {
+                fprintf(stderr, "bitmap %ux%u at (%u, %u) %s differs from the per-pixel path\n", w, h, x, y,
+                        color == White ? "white" : "black");
+                ok = false;
+            }
+        }
+    }
+    printf("bitmaps: %lu frames %s\n", (unsigned long)cases, ok ? "identical" : "DIFFER");
+    return ok;
+}
+
+static bool pixel(const uint8_t *frame, int x, int y)
+{
+    if (x < 0 || x >= SSD1306_WIDTH || y < 0 || y >= SSD1306_HEIGHT)
+        return false;
+    return frame[x + (y / 8) * SSD1306_WIDTH] & (1 << (y % 8));
+}
+
+// Every lit pixel of a has a lit pixel of b at most one pixel away
+static bool near(const uint8_t *a, const uint8_t *b)
+{
+    for (int y = 0; y < SSD1306_HEIGHT; y++)
+    {
+        for (int x = 0; x < SSD1306_WIDTH; x++)
+        {
+            if (!pixel(a, x, y))
+                continue;
+            bool found = false;
+            for (int dy = -1; dy <= 1 && !found; dy++)
+                for (int dx = -1; dx <= 1 && !found; dx++)
+                    found = pixel(b, x + dx, y + dy);
+            if (!found)
+                return false;
+        }
+    }
+    return true;
+}
+
+// Arcs of every radius that fits around the centre, at 5 degree steps.
+// Below 10 degrees there are no segments and the original path casts
+// sinf(inf) to int8_t, which is undefined, so sweeps start at 10
+static bool check_arcs(void)
+{
+    uint8_t actual[SSD1306_BUFFER_SIZE];
+    uint32_t cases = 0, exact = 0;
+    bool ok = true;
+
+    for (int with_radius = 0; with_radius < 2; with_radius++)
+    {
+        for (uint8_t radius = 1; radius <= 31; radius++)
+        {
+            for (uint16_t start = 0; start <= 360; start += 15)
+            {
+                for (uint16_t sweep = 10; sweep <= 360; sweep += 5, cases++)
+                {
+                    ssd1306_Fill(Black);
+                    if (with_radius)
+                        ssd1306_RefDrawArcWithRadiusLine(64, 32, radius, start, sweep, White);
+                    else
+                        ssd1306_RefDrawArc(64, 32, radius, start, sweep, White);
+                    snapshot(expected);
+
+                    ssd1306_Fill(Black);
+                    if (with_radius)
+                        ssd1306_DrawArcWithRadiusLine(64, 32, radius, start, sweep, White);
+                    else
+                        ssd1306_DrawArc(64, 32, radius, start, sweep, White);
+                    snapshot(actual);
+
+                    if (!memcmp(actual, expected, sizeof(actual)))
+                    {
+                        exact++;
+                    }
+                    else if (!near(actual, expected) || !near(expected, actual))
+                    {
+                        fprintf(stderr, "arc%s r=%u start=%u sweep=%u: more than a pixel from the sinf() path\n",
+                                with_radius ? " with radius" : "", radius, start, sweep);
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+    printf("arcs: %lu frames, %lu identical, %s\n", (unsigned long)cases, (unsigned long)exact,
+           ok ? "the rest within a pixel" : "DIFFER");
+    return ok;
+}
+
+// Receiver layout: two trend charts pushed together with send set, the way
+// the sensor screen scrolls them between full frames. After each push the
+// display RAM must already hold the screenbuffer
+static bool check_charts(void)
+{
+    uint8_t actual[SSD1306_BUFFER_SIZE];
+    trend_chart_t temp, umid;
+    trend_chart_t *const charts[] = {&temp, &umid};
+    bool ok = true;
+    uint32_t pushes;
+
+    new_background();
+    ssd1306_FillBuffer(background, sizeof(background));
+    ssd1306_DrawLineCustom(0, 31, 127, 31, White);
+    trend_chart_init(&temp, 98, 127, 0, 2, 0, 5000);
+    trend_chart_init(&umid, 98, 127, 5, 7, 0, 10000);
+    ssd1306_UpdateScreen();
+
+    for (pushes = 0; pushes < 200 && ok; pushes++)
+    {
+        const int16_t values[] = {(int16_t)(rng() % 6000 - 500), (int16_t)(rng() % 11000 - 500)};
+        trend_chart_push_group(charts, values, 2, true);
+
+        memcpy(actual, ssd1306_emu_ram(), sizeof(actual));
+        snapshot(expected);
+        if (memcmp(actual, expected, sizeof(actual)) != 0)
+        {
+            fprintf(stderr, "charts: display RAM differs from the screenbuffer after push %lu\n",
+                    (unsigned long)pushes + 1);
+            ok = false;
+        }
+    }
+    printf("charts: %lu pushes, %s\n", (unsigned long)pushes, ok ? "display RAM follows the screenbuffer" : "DIFFER");
+    return ok;
+}
+
+// ============================
+// === Benchmark ===
+// ============================
+
+typedef struct {
+    const char *name;
+    void (*ref)(uint32_t i);  // Original per-pixel path
+    void (*draw)(uint32_t i); // Driver
+} bench_t;
+
+static void ref_string(uint32_t i)
+{
+    static const char text[] = "23.45C";
+    const SSD1306_Font_t font = *fonts[0].ref;
+    for (uint8_t k = 0; text[k]; k++)
+        ssd1306_RefWriteChar(2 + k * font.width, 5 + i % 8, text[k], font, White);
+}
+
+static void draw_string(uint32_t i)
+{
+    ssd1306_SetCursor(2, 5 + i % 8);
+    ssd1306_WriteString("23.45C", *fonts[0].font, White);
+}
+
+static void draw_string_rows(uint32_t i)
+{
+    ssd1306_SetCursor(2, 5 + i % 8);
+    ssd1306_WriteString("23.45C", *fonts[0].ref, White);
+}
+
+static const uint8_t bench_bitmap[32 * 32 / 8] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0x80, 0x00, 0x00, 0x01, 0xBF, 0xFF, 0xFF, 0xFD, 0xA0, 0x00, 0x00, 0x05,
+    0xAF, 0xFF, 0xFF, 0xF5, 0xA8, 0x00, 0x00, 0x15, 0xAB, 0xFF, 0xFF, 0xD5, 0xAA, 0x00, 0x00, 0x55,
+    0xAA, 0xFF, 0xFF, 0x55, 0xAA, 0x80, 0x01, 0x55, 0xAA, 0xBF, 0xFD, 0x55, 0xAA, 0xA0, 0x05, 0x55,
+    0xAA, 0xAF, 0xF5, 0x55, 0xAA, 0xA8, 0x15, 0x55, 0xAA, 0xAB, 0xD5, 0x55, 0xAA, 0xAA, 0x55, 0x55,
+    0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAB, 0xD5, 0x55, 0xAA, 0xA8, 0x15, 0x55, 0xAA, 0xAF, 0xF5, 0x55,
+    0xAA, 0xA0, 0x05, 0x55, 0xAA, 0xBF, 0xFD, 0x55, 0xAA, 0x80, 0x01, 0x55, 0xAA, 0xFF, 0xFF, 0x55,
+    0xAA, 0x00, 0x00, 0x55, 0xAB, 0xFF, 0xFF, 0xD5, 0xA8, 0x00, 0x00, 0x15, 0xAF, 0xFF, 0xFF, 0xF5,
+    0xA0, 0x00, 0x00, 0x05, 0xBF, 0xFF, 0xFF, 0xFD, 0x80, 0x00, 0x00, 0x01, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static void ref_bitmap(uint32_t i)
+{
+    ssd1306_RefDrawBitmap(48 + i % 4, 16 + i % 8, bench_bitmap, 32, 32, White);
+}
+
+static void draw_bitmap(uint32_t i)
+{
+    ssd1306_DrawBitmap(48 + i % 4, 16 + i % 8, bench_bitmap, 32, 32, White);
+}
+
+static void ref_arc(uint32_t i)
+{
+    ssd1306_RefDrawArc(64, 32, 28, i % 90, 270, White);
+}
+
+static void draw_arc(uint32_t i)
+{
+    ssd1306_DrawArc(64, 32, 28, i % 90, 270, White);
+}
+
+static void ref_gauge(uint32_t i)
+{
+    ssd1306_RefDrawArcWithRadiusLine(64, 32, 28, 0, 1 + i % 359, White);
+}
+
+static void draw_gauge(uint32_t i)
+{
+    ssd1306_DrawArcWithRadiusLine(64, 32, 28, 0, 1 + i % 359, White);
+}
+
+static const bench_t benches[] = {
+    {"string", ref_string, draw_string},
+    {"string_rows", ref_string, draw_string_rows},
+    {"bitmap", ref_bitmap, draw_bitmap},
+    {"arc", ref_arc, draw_arc},
+    {"gauge", ref_gauge, draw_gauge},
+};
+
+static uint64_t now_ns(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + t.tv_nsec;
+}
+
+static uint64_t now_cycles(void)
+{
+#ifdef CHECK_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Time per call in ns and cycles
+static void bench_run(void (*draw)(uint32_t), double *ns, double *cycles)
+{
+    uint32_t runs = 0;
+    uint64_t elapsed;
+
+    ssd1306_Fill(Black);
+    const uint64_t start = now_ns();
+    const uint64_t start_cycles = now_cycles();
+    do
+    {
+        for (uint32_t k = 0; k < 64; k++, runs++)
+            draw(runs);
+        elapsed = now_ns() - start;
+    } while (elapsed < BENCH_MIN_NS);
+
+    *ns = (double)elapsed / runs;
+    *cycles = (double)(now_cycles() - start_cycles) / runs;
+}
+
+static void bench(void)
+{
+    printf("\n%-12s %12s %12s %12s %12s %8s\n", "primitive", "ref ns/op", "ns/op", "ref cyc/op", "cyc/op", "speedup");
+    for (size_t n = 0; n < sizeof(benches) / sizeof(benches[0]); n++)
+    {
+        const bench_t *b = &benches[n];
+        double ref_ns, ref_cycles, ns, cycles;
+
+        bench_run(b->ref, &ref_ns, &ref_cycles);
+        bench_run(b->draw, &ns, &cycles);
+        printf("%-12s %12.1f %12.1f %12.0f %12.0f %7.1fx\n", b->name, ref_ns, ns, ref_cycles, cycles, ref_ns / ns);
+    }
+}
+
+int main(void)
+{
+    bool ok = true;
+
+    ssd1306_emu_reset();
+    ssd1306_Init();
+
+    ok &= check_glyphs(false);
+    ok &= check_glyphs(true);
+    ok &= check_bitmaps();
+    ok &= check_arcs();
+    ok &= check_charts();
+    bench();
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+#include "ssd1306_emu.h"
+#include "ssd1306_host.h"
+#include <stdio.h>
+#include <string.h>
+
+// Longest command: 0x26/0x27 and 0x2C/0x2D take 6 parameters
+#define EMU_MAX_PARAMS 6
+
+static struct {
+    uint8_t ram[SSD1306_EMU_PAGES][SSD1306_EMU_WIDTH];
+
+    // Addressing
+    uint8_t mode; // 0 horizontal, 1 vertical, 2 page
+    uint8_t col, page;
+    uint8_t col_start, col_end;
+    uint8_t page_start, page_end;
+    uint8_t page_col_start; // Column start of page addressing (0x00-0x1F)
+
+    // Display
+    uint8_t start_line;
+    bool seg_remap; // 0xA1
+    bool com_remap; // 0xC8
+    bool inverse;   // 0xA7
+    bool all_on;    // 0xA5
+    bool on;        // 0xAF
+    uint8_t contrast;
+
+    // Continuous scroll set up by 0x26/0x27/0x29/0x2A, run by 0x2F
+    bool scroll_active;
+    bool scroll_left;
+    uint8_t scroll_start, scroll_end;
+    uint16_t scroll_interval; // Frames between steps
+    uint8_t scroll_vertical;  // Rows per step (0x29/0x2A)
+    uint32_t scroll_frames;
+
+    // Command being collected
+    uint8_t cmd[1 + EMU_MAX_PARAMS];
+    uint8_t cmd_len;
+
+    ssd1306_emu_stats_t stats;
+} emu;
+
+// Frames between scroll steps, indexed by the 3-bit interval code
+static const uint16_t emu_scroll_frames[8] = {5, 64, 128, 256, 3, 4, 25, 2};
+
+static uint8_t emu_param_count(uint8_t cmd)
+{
+    switch (cmd)
+    {
+    case 0x81: case 0x20: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1;
+    case 0x21: case 0x22: case 0xA3:
+        return 2;
+    case 0x29: case 0x2A:
+        return 5;
+    case 0x26: case 0x27: case 0x2C: case 0x2D:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+// Rotate columns x1..x2 of pages p1..p2 by one column
+static void emu_rotate(uint8_t p1, uint8_t p2, uint8_t x1, uint8_t x2, bool left)
+{
+    for (uint8_t page = p1; page <= p2 && page < SSD1306_EMU_PAGES; page++)
+    {
+        uint8_t *row = emu.ram[page];
+        uint8_t wrap;
+        if (left)
+        {
+            wrap = row[x1];
+            memmove(&row[x1], &row[x1 + 1], x2 - x1);
+            row[x2] = wrap;
+        }
+        else
+        {
+            wrap = row[x2];
+            memmove(&row[x1 + 1], &row[x1], x2 - x1);
+            row[x1] = wrap;
+        }
+    }
+}
+
+static void emu_command(const uint8_t *c)
+{
+    switch (c[0])
+    {
+    case 0x20: emu.mode = c[1] & 0x03; break;
+    case 0x21:
+        emu.col_start = c[1] & 0x7F;
+        emu.col_end = c[2] & 0x7F;
+        emu.col = emu.col_start;
+        break;
+    case 0x22:
+        emu.page_start = c[1] & 0x07;
+        emu.page_end = c[2] & 0x07;
+        emu.page = emu.page_start;
+        break;
+    case 0x81: emu.contrast = c[1]; break;
+    case 0xA0: case 0xA1: emu.seg_remap = c[0] & 1; break;
+    case 0xA4: case 0xA5: emu.all_on = c[0] & 1; break;
+    case 0xA6: case 0xA7: emu.inverse = c[0] & 1; break;
+    case 0xAE: case 0xAF: emu.on = c[0] & 1; break;
+    case 0xC0: emu.com_remap = false; break;
+    case 0xC8: emu.com_remap = true; break;
+    case 0x26: case 0x27: case 0x29: case 0x2A:
+        emu.scroll_active = false;
+        emu.scroll_left = (c[0] == 0x27) || (c[0] == 0x2A);
+        emu.scroll_start = c[2] & 0x07;
+        emu.scroll_interval = emu_scroll_frames[c[3] & 0x07];
+        emu.scroll_end = c[4] & 0x07;
+        emu.scroll_vertical = (c[0] >= 0x29) ? (c[5] & 0x3F) : 0;
+        break;
+    case 0x2C: case 0x2D:
+        emu_rotate(c[2] & 0x07, c[4] & 0x07, c[5] & 0x7F, c[6] & 0x7F, c[0] == 0x2D);
+        break;
+    case 0x2E: emu.scroll_active = false; break;
+    case 0x2F:
+        emu.scroll_active = true;
+        emu.scroll_frames = 0;
+        break;
+    default:
+        if (c[0] <= 0x0F)
+        {
+            emu.page_col_start = (emu.page_col_start & 0xF0) | c[0];
+            emu.col = emu.page_col_start;
+        }
+        else if (c[0] <= 0x1F)
+        {
+            emu.page_col_start = (emu.page_col_start & 0x0F) | ((c[0] & 0x07) << 4);
+            emu.col = emu.page_col_start;
+        }
+        else if (c[0] >= 0x40 && c[0] <= 0x7F)
+        {
+            emu.start_line = c[0] & 0x3F;
+        }
+        else if (c[0] >= 0xB0 && c[0] <= 0xB7)
+        {
+            emu.page = c[0] & 0x07;
+        }
+        // Timing, charge pump, multiplex etc. do not change the picture
+        break;
+    }
+}
+
+static void emu_command_byte(uint8_t byte)
+{
+    emu.cmd[emu.cmd_len++] = byte;
+    if (emu.cmd_len > emu_param_count(emu.cmd[0]))
+    {
+        emu_command(emu.cmd);
+        emu.cmd_len = 0;
+    }
+}
+
+static void emu_data_byte(uint8_t byte)
+{
+    emu.ram[emu.page][emu.col] = byte;
+    emu.stats.data_bytes++;
+
+    switch (emu.mode)
+    {
+    case 0: // Horizontal: along the window row, then the next page
+        if (emu.col++ >= emu.col_end)
+        {
+            emu.col = emu.col_start;
+            if (emu.page++ >= emu.page_end)
+                emu.page = emu.page_start;
+        }
+        break;
+    case 1: // Vertical: down the window column, then the next column
+        if (emu.page++ >= emu.page_end)
+        {
+            emu.page = emu.page_start;
+            if (emu.col++ >= emu.col_end)
+                emu.col = emu.col_start;
+        }
+        break;
+    default: // Page: wraps within the page
+        if (++emu.col >= SSD1306_EMU_WIDTH)
+            emu.col = emu.page_col_start;
+        break;
+    }
+}
+
+void ssd1306_emu_reset(void)
+{
+    memset(&emu, 0, sizeof(emu));
+    emu.mode = 2;
+    emu.col_end = SSD1306_EMU_WIDTH - 1;
+    emu.page_end = SSD1306_EMU_PAGES - 1;
+    emu.contrast = 0x7F;
+}
+
+void ssd1306_emu_write(const uint8_t *buf, size_t len)
+{
+    emu.stats.transactions++;
+    emu.stats.bytes += 1 + len; // Address byte
+
+    // Control byte: bit 6 selects data, bit 7 (Co) means a single byte
+    // follows before the next control byte
+    size_t i = 0;
+    while (i < len)
+    {
+        const uint8_t control = buf[i++];
+        const bool data = control & 0x40;
+        const size_t end = (control & 0x80) ? ((i < len) ? i + 1 : len) : len;
+
+        for (; i < end; i++)
+        {
+            if (data)
+                emu_data_byte(buf[i]);
+            else
+                emu_command_byte(buf[i]);
+        }
+    }
+}
+
+bool ssd1306_HostWrite(const uint8_t *buf, size_t len)
+{
+    ssd1306_emu_write(buf, len);
+    return true;
+}
+
+void ssd1306_emu_step(uint32_t frames)
+{
+    if (!emu.scroll_active)
+        return;
+
+    for (emu.scroll_frames += frames; emu.scroll_frames >= emu.scroll_interval;
+         emu.scroll_frames -= emu.scroll_interval)
+    {
+        emu_rotate(emu.scroll_start, emu.scroll_end, 0, SSD1306_EMU_WIDTH - 1, emu.scroll_left);
+        emu.start_line = (emu.start_line + emu.scroll_vertical) & 0x3F;
+    }
+}
+
+const uint8_t *ssd1306_emu_ram(void)
+{
+    return &emu.ram[0][0];
+}
+
+void ssd1306_emu_render(uint8_t image[SSD1306_EMU_HEIGHT][SSD1306_EMU_WIDTH])
+{
+    for (int y = 0; y < SSD1306_EMU_HEIGHT; y++)
+    {
+        // Orientation as mounted on the usual 128x64 modules, where the
+        // driver's 0xA1/0xC8 init gives an upright picture
+        const int com = emu.com_remap ? y : SSD1306_EMU_HEIGHT - 1 - y;
+        const int row = (com + emu.start_line) % SSD1306_EMU_HEIGHT;
+
+        for (int x = 0; x < SSD1306_EMU_WIDTH; x++)
+        {
+            const int col = emu.seg_remap ? x : SSD1306_EMU_WIDTH - 1 - x;
+            bool lit = (emu.ram[row / 8][col] >> (row % 8)) & 1;
+            lit = (lit || emu.all_on) != emu.inverse;
+            image[y][x] = (emu.on && lit) ? 255 : 0;
+        }
+    }
+}
+
+bool ssd1306_emu_save_pgm(const char *path)
+{
+    uint8_t image[SSD1306_EMU_HEIGHT][SSD1306_EMU_WIDTH];
+    FILE *f = fopen(path, "wb");
+    if (!f)
+        return false;
+
+    ssd1306_emu_render(image);
+    fprintf(f, "P5\n%d %d\n255\n", SSD1306_EMU_WIDTH, SSD1306_EMU_HEIGHT);
+    bool ok = fwrite(image, sizeof(image), 1, f) == 1;
+    return (fclose(f) == 0) && ok;
+}
+
+ssd1306_emu_stats_t ssd1306_emu_stats(void)
+{
+    return emu.stats;
+}
+
+void ssd1306_emu_reset_stats(void)
+{
+    memset(&emu.stats, 0, sizeof(emu.stats));
+}
+
+uint32_t ssd1306_emu_bus_us(ssd1306_emu_stats_t stats, uint32_t clk_khz)
+{
+    const uint64_t clocks = (uint64_t)stats.bytes * 9 + (uint64_t)stats.transactions * 2;
+    return (uint32_t)(clocks * 1000 / clk_khz);
+}
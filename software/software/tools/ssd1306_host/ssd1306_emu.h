@@ -0,0 +1,53 @@
+/**
+ * SSD1306 emulator for host builds of the driver.
+ *
+ * Interprets the I2C command/data stream like the controller: control
+ * bytes (with continuation), horizontal/vertical/page addressing, column
+ * and page windows, display start line, segment/COM remap, inversion,
+ * continuous horizontal scroll and one column content scroll. Frames can
+ * be rendered as seen on the panel and saved as PGM.
+ */
+
+#ifndef __SSD1306_EMU_H__
+#define __SSD1306_EMU_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SSD1306_EMU_WIDTH  128
+#define SSD1306_EMU_HEIGHT 64
+#define SSD1306_EMU_PAGES  (SSD1306_EMU_HEIGHT / 8)
+
+/** Bus traffic since the last ssd1306_emu_reset_stats() */
+typedef struct {
+    uint32_t transactions; /**< START..STOP write transactions */
+    uint32_t bytes;        /**< Bytes on the bus, address bytes included */
+    uint32_t data_bytes;   /**< Bytes written to display RAM */
+} ssd1306_emu_stats_t;
+
+/** Power-on state: RAM cleared, display off, page addressing */
+void ssd1306_emu_reset(void);
+
+/** Feed one write transaction (control byte first, no address byte) */
+void ssd1306_emu_write(const uint8_t *buf, size_t len);
+
+/** Advance the panel clock by `frames` frames (continuous scroll) */
+void ssd1306_emu_step(uint32_t frames);
+
+/** Display RAM, page-major like the driver's screenbuffer */
+const uint8_t *ssd1306_emu_ram(void);
+
+/** Picture on the glass, one byte per pixel (0 or 255), row-major */
+void ssd1306_emu_render(uint8_t image[SSD1306_EMU_HEIGHT][SSD1306_EMU_WIDTH]);
+
+/** Write the rendered picture as a binary PGM, returns false on I/O errors */
+bool ssd1306_emu_save_pgm(const char *path);
+
+ssd1306_emu_stats_t ssd1306_emu_stats(void);
+void ssd1306_emu_reset_stats(void);
+
+/** Bus time of `stats` in microseconds at `clk_khz`, 9 clocks per byte plus START/STOP */
+uint32_t ssd1306_emu_bus_us(ssd1306_emu_stats_t stats, uint32_t clk_khz);
+
+#endif // __SSD1306_EMU_H__
@@ -0,0 +1,38 @@
+/**
+ * Host build of inc/ssd1306.c (SSD1306_HOST): stands in for the Pico SDK
+ * headers the driver needs and routes its bus writes to the emulator.
+ */
+
+#ifndef __SSD1306_HOST_H__
+#define __SSD1306_HOST_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One I2C write transaction to the panel, without the address byte.
+ * @return true when the (emulated) panel acknowledged it.
+ */
+bool ssd1306_HostWrite(const uint8_t *buf, size_t len);
+
+// The emulated panel is ready at once, so ssd1306_WaitReady() never waits
+typedef uint64_t absolute_time_t;
+
+static inline absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return ms;
+}
+
+static inline bool time_reached(absolute_time_t t)
+{
+    (void)t;
+    return true;
+}
+
+static inline void sleep_us(uint64_t us)
+{
+    (void)us;
+}
+
+#endif // __SSD1306_HOST_H__
@@ -0,0 +1,187 @@
+#include "ssd1306_ref.h"
+#include <math.h>
+
+// Row-major tables under their own names: the driver's Font_* come from
+// the generated page/column file
+#define Font_6x8   Ref_Font_6x8
+#define Font_7x10  Ref_Font_7x10
+#define Font_11x18 Ref_Font_11x18
+#define Font_16x26 Ref_Font_16x26
+#define Font_16x24 Ref_Font_16x24
+#define Font_16x15 Ref_Font_16x15
+#include "ssd1306_fonts.c"
+
+char ssd1306_RefWriteChar(uint8_t x, uint8_t y, char ch, SSD1306_Font_t Font, SSD1306_COLOR color)
+{
+    uint32_t i, b, j;
+
+    // Check if character is valid
+    if (ch < 32 || ch > 126)
+        return 0;
+
+    // Check remaining space on current line
+    if (SSD1306_WIDTH < (x + Font.width) ||
+        SSD1306_HEIGHT < (y + Font.height))
+    {
+        // Not enough space on current line
+        return 0;
+    }
+
+    // Use the font to write
+    for (i = 0; i < Font.height; i++)
+    {
+        b = Font.data[(ch - 32) * Font.height + i];
+        for (j = 0; j < Font.width; j++)
+        {
+            if ((b << j) & 0x8000)
+            {
+                ssd1306_DrawPixel(x + j, (y + i), (SSD1306_COLOR)color);
+            }
+            else
+            {
+                ssd1306_DrawPixel(x + j, (y + i), (SSD1306_COLOR)!color);
+            }
+        }
+    }
+
+    return ch;
+}
+
+void ssd1306_RefDrawBitmap(uint8_t x, uint8_t y, const unsigned char *bitmap, uint8_t w, uint8_t h, SSD1306_COLOR color)
+{
+    int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
+    uint8_t byte = 0;
+
+    if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT)
+    {
+        return;
+    }
+
+    for (uint8_t j = 0; j < h; j++, y++)
+    {
+        for (uint8_t i = 0; i < w; i++)
+        {
+            if (i & 7)
+            {
+                byte <<= 1;
+            }
+            else
+            {
+                byte = (*(const unsigned char *)(&bitmap[j * byteWidth + i / 8]));
+            }
+
+            if (byte & 0x80)
+            {
+                ssd1306_DrawPixel(x + i, y, color);
+            }
+        }
+    }
+    return;
+}
+
+/* Convert Degrees to Radians */
+static float ssd1306_DegToRad(float par_deg)
+{
+    return par_deg * (3.14f / 180.0f);
+}
+
+/* Normalize degree to [0;360] */
+static uint16_t ssd1306_NormalizeTo0_360(uint16_t par_deg)
+{
+    uint16_t loc_angle;
+    if (par_deg <= 360)
+    {
+        loc_angle = par_deg;
+    }
+    else
+    {
+        loc_angle = par_deg % 360;
+        loc_angle = (loc_angle ? loc_angle : 360);
+    }
+    return loc_angle;
+}
+
+void ssd1306_RefDrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color)
+{
+    static const uint8_t CIRCLE_APPROXIMATION_SEGMENTS = 36;
+    float approx_degree;
+    uint32_t approx_segments;
+    uint8_t xp1, xp2;
+    uint8_t yp1, yp2;
+    uint32_t count;
+    uint32_t loc_sweep;
+    float rad;
+
+    loc_sweep = ssd1306_NormalizeTo0_360(sweep);
+
+    count = (ssd1306_NormalizeTo0_360(start_angle) * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
+    approx_segments = (loc_sweep * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
+    approx_degree = loc_sweep / (float)approx_segments;
+    while (count < approx_segments)
+    {
+        rad = ssd1306_DegToRad(count * approx_degree);
+        xp1 = x + (int8_t)(sinf(rad) * radius);
+        yp1 = y + (int8_t)(cosf(rad) * radius);
+        count++;
+        if (count != approx_segments)
+        {
+            rad = ssd1306_DegToRad(count * approx_degree);
+        }
+        else
+        {
+            rad = ssd1306_DegToRad(loc_sweep);
+        }
+        xp2 = x + (int8_t)(sinf(rad) * radius);
+        yp2 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_Line(xp1, yp1, xp2, yp2, color);
+    }
+
+    return;
+}
+
+void ssd1306_RefDrawArcWithRadiusLine(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color)
+{
+    const uint32_t CIRCLE_APPROXIMATION_SEGMENTS = 36;
+    float approx_degree;
+    uint32_t approx_segments;
+    uint8_t xp1;
+    uint8_t xp2 = 0;
+    uint8_t yp1;
+    uint8_t yp2 = 0;
+    uint32_t count;
+    uint32_t loc_sweep;
+    float rad;
+
+    loc_sweep = ssd1306_NormalizeTo0_360(sweep);
+
+    count = (ssd1306_NormalizeTo0_360(start_angle) * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
+    approx_segments = (loc_sweep * CIRCLE_APPROXIMATION_SEGMENTS) / 360;
+    approx_degree = loc_sweep / (float)approx_segments;
+
+    rad = ssd1306_DegToRad(count * approx_degree);
+    uint8_t first_point_x = x + (int8_t)(sinf(rad) * radius);
+    uint8_t first_point_y = y + (int8_t)(cosf(rad) * radius);
+    while (count < approx_segments)
+    {
+        rad = ssd1306_DegToRad(count * approx_degree);
+        xp1 = x + (int8_t)(sinf(rad) * radius);
+        yp1 = y + (int8_t)(cosf(rad) * radius);
+        count++;
+        if (count != approx_segments)
+        {
+            rad = ssd1306_DegToRad(count * approx_degree);
+        }
+        else
+        {
+            rad = ssd1306_DegToRad(loc_sweep);
+        }
+        xp2 = x + (int8_t)(sinf(rad) * radius);
+        yp2 = y + (int8_t)(cosf(rad) * radius);
+        ssd1306_Line(xp1, yp1, xp2, yp2, color);
+    }
+
+    // Radius line
+    ssd1306_Line(x, y, first_point_x, first_point_y, color);
+    ssd1306_Line(x, y, xp2, yp2, color);
+    return;
+}
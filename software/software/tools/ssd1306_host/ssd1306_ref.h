@@ -0,0 +1,46 @@
+/**
+ * Reference drawing paths for host checks of the SSD1306 driver.
+ *
+ * The driver's original per-pixel and floating-point implementations,
+ * kept verbatim on top of ssd1306_DrawPixel() and ssd1306_Line() so the
+ * optimised primitives can be compared with them pixel by pixel and timed
+ * against them. The row-major font tables
+ * of ssd1306_fonts.c are built here under the Ref_ prefix, next to the
+ * page/column tables the driver draws from.
+ */
+
+#ifndef __SSD1306_REF_H__
+#define __SSD1306_REF_H__
+
+#include "ssd1306.h"
+
+#ifdef SSD1306_INCLUDE_FONT_6x8
+extern const SSD1306_Font_t Ref_Font_6x8;
+#endif
+#ifdef SSD1306_INCLUDE_FONT_7x10
+extern const SSD1306_Font_t Ref_Font_7x10;
+#endif
+#ifdef SSD1306_INCLUDE_FONT_11x18
+extern const SSD1306_Font_t Ref_Font_11x18;
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x26
+extern const SSD1306_Font_t Ref_Font_16x26;
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x24
+extern const SSD1306_Font_t Ref_Font_16x24;
+#endif
+#ifdef SSD1306_INCLUDE_FONT_16x15
+extern const SSD1306_Font_t Ref_Font_16x15;
+#endif
+
+/** Opaque glyph cell through ssd1306_DrawPixel(), as ssd1306_WriteChar() drew it */
+char ssd1306_RefWriteChar(uint8_t x, uint8_t y, char ch, SSD1306_Font_t Font, SSD1306_COLOR color);
+
+/** Bitmap through ssd1306_DrawPixel(), as ssd1306_DrawBitmap() drew it */
+void ssd1306_RefDrawBitmap(uint8_t x, uint8_t y, const unsigned char *bitmap, uint8_t w, uint8_t h, SSD1306_COLOR color);
+
+/** Arcs from sinf()/cosf() with the original 3.14f, as ssd1306_DrawArc*() drew them */
+void ssd1306_RefDrawArc(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color);
+void ssd1306_RefDrawArcWithRadiusLine(uint8_t x, uint8_t y, uint8_t radius, uint16_t start_angle, uint16_t sweep, SSD1306_COLOR color);
+
+#endif // __SSD1306_REF_H__